@@ -0,0 +1,113 @@
+//include statements for various functions
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "ElectionLibrary.h"
+
+using namespace std;
+
+// the map, electorates and campaign days of the elections the allocations are counted on
+static const char* allocScenario = "uniform:20000:500000";
+static const int allocElectorates = 1000;
+static const int allocDays = 100;
+// the shorter campaign the setup allocations are compared with, they can't depend on the number of days
+static const int allocShortDays = 10;
+// the number of campaign threads used by the parallel campaign case
+static const int allocCampaignThreads = 4;
+
+// allocations counts every allocation made while counting is set, from any thread
+static atomic<long> allocations(0);
+static atomic<bool> counting(false);
+
+// global operator new and delete which count the allocations made while counting is set
+void* operator new(size_t size){
+    if(counting) allocations++;
+    void* memory = malloc(size ? size : 1);
+    if(!memory) throw bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, align_val_t alignment){
+    if(counting) allocations++;
+    void* memory = aligned_alloc(static_cast<size_t>(alignment), (size + static_cast<size_t>(alignment) - 1) / static_cast<size_t>(alignment) * static_cast<size_t>(alignment));
+    if(!memory) throw bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept{
+    free(memory);
+}
+
+void operator delete(void* memory, align_val_t) noexcept{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t, align_val_t) noexcept{
+    free(memory);
+}
+
+// function used to count the allocations of the campaign and of the vote tally of one election
+// the election is generated first as only the campaign and the tally have to be allocation free
+void countAllocations(int days, int campaignThreads, CampaignOrder order, long& campaignAllocations, long& tallyAllocations){
+
+    ScenarioSpec scenario;
+    scenario.parse(allocScenario, 1);
+
+    Election election(allocElectorates, days, 1, 0, NarrationLevel::SILENT);
+    election.setScenario(scenario);
+    election.setCampaignThreads(campaignThreads);
+    election.setCampaignOrder(order);
+    election.generateElection();
+
+    allocations = 0;
+    counting = true;
+    election.runCampaign();
+    counting = false;
+    campaignAllocations = allocations;
+
+    allocations = 0;
+    counting = true;
+    election.calculatePopularity();
+    election.tallyVotes();
+    counting = false;
+    tallyAllocations = allocations;
+}
+
+// function used to run one case of the test
+// the campaign of the serial day order has to make no allocations at all, the electorate major and parallel campaigns
+// are allowed their setup at the start of each runCampaign call (the workers, their threads and the leader influences
+// of the days being run) which has to be the same for a short campaign, the tally never allocates.
+bool runCase(const string& name, int campaignThreads, CampaignOrder order, bool allowSetup){
+
+    long campaignAllocations, tallyAllocations, shortCampaignAllocations, shortTallyAllocations;
+    countAllocations(allocDays, campaignThreads, order, campaignAllocations, tallyAllocations);
+    countAllocations(allocShortDays, campaignThreads, order, shortCampaignAllocations, shortTallyAllocations);
+
+    bool passed = tallyAllocations == 0 && shortTallyAllocations == 0;
+    if(allowSetup) passed &= campaignAllocations == shortCampaignAllocations;
+    else passed &= campaignAllocations == 0 && shortCampaignAllocations == 0;
+
+    cout<<(passed ? "ok   " : "FAIL ")<<name<<": campaign "<<campaignAllocations<<" allocations over "<<allocDays<<" days ("
+        <<shortCampaignAllocations<<" over "<<allocShortDays<<"), tally "<<tallyAllocations<<endl;
+    return passed;
+}
+
+// Main function which counts the allocations of the campaign and tally in every campaign order
+// returns 1 if any of them allocate more than they are allowed
+int main(){
+
+    cout<<"# Election Simulator allocation test, "<<allocElectorates<<" electorates over "<<allocDays<<" days"<<endl;
+
+    bool passed = true;
+    passed &= runCase("runCampaign", 1, CampaignOrder::DAY_MAJOR, false);
+    passed &= runCase("runCampaign/order=electorate", 1, CampaignOrder::ELECTORATE_MAJOR, true);
+    passed &= runCase("runCampaign/campaignThreads=" + to_string(allocCampaignThreads), allocCampaignThreads, CampaignOrder::DAY_MAJOR, true);
+
+    return passed ? 0 : 1;
+}
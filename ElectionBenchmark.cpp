@@ -0,0 +1,432 @@
+//include statements for various functions
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include "ElectionLibrary.h"
+
+using namespace std;
+
+// the version of the output format, changed whenever a benchmark is added, removed or renamed
+// so results are only ever compared with results of the same format
+static const int benchFormatVersion = 7;
+// the map every benchmark election is generated from, the map seed is the benchmark seed
+static const char* benchScenario = "uniform:20000:80000";
+// the electorates and campaign days of the elections used by the micro benchmarks
+static const int microElectorates = 2000;
+static const int microDays = 30;
+// the campaign days of the end to end runs
+static const int endToEndDays = 20;
+// how many times each event is run by the processEvent benchmark
+static const int eventCalls = 2000;
+// how many characteristic reads/updates and candidate copies are timed by the characteristics benchmark
+static const int characteristicCalls = 1000000;
+static const int candidateCopies = 200000;
+// number of forks and restores timed for each repeat of the branching benchmark
+static const int branchCalls = 200;
+// the width of the benchmark name column
+static const int benchNameWidth = 56;
+
+// function used to print one benchmark result as its name, value and unit
+// every result is one line so the results of two commits can be compared with diff
+void printResult(const string& name, double value, const string& unit){
+    cout<<left<<setw(benchNameWidth)<<name<<right<<setw(16)<<fixed<<setprecision(2)<<value<<" "<<unit<<endl;
+}
+
+// function used to get the seconds since the start time
+double secondsSince(chrono::steady_clock::time_point start){
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// function used to generate a benchmark election with no narration
+// every benchmark election uses the same map and seed so the campaign events are the same every time it is run
+void setUpElection(Election& election, uint64_t seed){
+    ScenarioSpec scenario;
+    scenario.parse(benchScenario, seed);
+    election.setScenario(scenario);
+    election.generateElection();
+}
+
+// function used to benchmark the vote tally kernel, countStancesWon, on every cluster of an election
+// the clusters are counted in the same blocks the vote tally uses
+void benchCountStancesWon(uint64_t seed, int repeats){
+
+    Election election(microElectorates, 1, seed, 0, NarrationLevel::SILENT);
+    setUpElection(election, seed);
+    election.buildCandidateMatrix();
+
+    VoterStore& voters = election.getVoters();
+    CandidateMatrix& matrix = election.getCandidateMatrix();
+    const int blockSize = 4096;
+    const int passes = 20;
+    vector<uint8_t> stancesWon(matrix.numOfParties * blockSize);
+
+    double best = -1;
+    for(int repeat = 0; repeat < repeats; repeat++){
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int pass = 0; pass < passes; pass++){
+            for(int first = 0; first < voters.getNumOfClusters(); first += blockSize){
+                countStancesWon(voters, matrix, first, min(blockSize, voters.getNumOfClusters() - first), stancesWon.data());
+            }
+        }
+        double seconds = secondsSince(start);
+        if(best < 0 || seconds < best) best = seconds;
+    }
+
+    printResult("countStancesWon", best * 1e9 / ((double)passes * voters.getNumOfClusters()), "ns/cluster");
+}
+
+// function used to benchmark the vote tally, which counts the stances won then calculates the votes
+// of every candidate for each cluster with calculateClusterVotes
+// the tally can only be run once for an election so each repeat generates a new one
+void benchTallyVotes(uint64_t seed, int repeats){
+
+    double best = -1;
+    int numOfClusters = 0;
+    for(int repeat = 0; repeat < repeats; repeat++){
+        Election election(microElectorates, 1, seed, 0, NarrationLevel::SILENT);
+        setUpElection(election, seed);
+        numOfClusters = election.getVoters().getNumOfClusters();
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        election.tallyVotes();
+        double seconds = secondsSince(start);
+        if(best < 0 || seconds < best) best = seconds;
+    }
+
+    printResult("tallyVotes/calculateClusterVotes", best * 1e9 / numOfClusters, "ns/cluster");
+}
+
+// function used to benchmark the characteristics of a person, which the events and the vote tally read and update,
+// a read of charisma and an update of popularity as an event makes them, a copy of a candidate and
+// the popularity bonus of every candidate read into the candidate matrix before the tally.
+// the values read are added up so the compiler can't skip them
+void benchCharacteristics(uint64_t seed, int repeats){
+
+    Election election(microElectorates, 1, seed, 0, NarrationLevel::SILENT);
+    setUpElection(election, seed);
+    Candidate& candidate = election.getCandidates().getCandidate(0, 0);
+
+    double best[3] = {-1, -1, -1};
+    uint64_t total = 0;
+    for(int repeat = 0; repeat < repeats; repeat++){
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int call = 0; call < characteristicCalls; call++){
+            total += candidate.getCharValue(Characteristic::CHARISMA);
+            candidate.updateChar(Characteristic::POPULARITY, call % 2 == 0 ? 3 : -3);
+        }
+        double seconds = secondsSince(start);
+        if(best[0] < 0 || seconds < best[0]) best[0] = seconds;
+
+        start = chrono::steady_clock::now();
+        for(int copy = 0; copy < candidateCopies; copy++){
+            Candidate candidateCopy = candidate;
+            total += candidateCopy.getCharValue(Characteristic::CHARISMA);
+        }
+        seconds = secondsSince(start);
+        if(best[1] < 0 || seconds < best[1]) best[1] = seconds;
+
+        start = chrono::steady_clock::now();
+        election.buildCandidateMatrix();
+        seconds = secondsSince(start);
+        if(best[2] < 0 || seconds < best[2]) best[2] = seconds;
+    }
+
+    int numOfCandidates = microElectorates * election.getParties().size();
+    printResult("characteristics/getCharValue+updateChar", best[0] * 1e9 / characteristicCalls, "ns/pair");
+    printResult("characteristics/Candidate copy", best[1] * 1e9 / candidateCopies, "ns/copy");
+    printResult("characteristics/buildCandidateMatrix", best[2] * 1e9 / numOfCandidates, "ns/candidate");
+    if(total == 0) cout<<"# no characteristics were read"<<endl;
+}
+
+// function used to benchmark drawing random numbers, in millions of draws a second
+// the rolls are drawn one at a time and a whole array at a time, like the influences draw them,
+// from one long stream and from streams of randomStreamLength rolls, the length of the stream
+// of an electorate of 4 clusters influenced on 5 issues, as most streams of the campaign are only a few blocks long.
+// the rolls are added up so the compiler can't skip them
+void benchRandom(uint64_t seed, int repeats){
+
+    const int rolls = 1 << 22;
+    const int randomStreamLength = 20;
+    const int arrayLength = 200;
+    RandomGenerator random(seed, 0);
+    int values[arrayLength];
+    int64_t total = 0;
+
+    double best[5] = {-1, -1, -1, -1, -1};
+    for(int repeat = 0; repeat < repeats; repeat++){
+        double seconds[5];
+
+        random.setStream(RandomStream::NATIONAL, repeat, 0);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int roll = 0; roll < rolls; roll++) total += random.randomIntRange(1, 3);
+        seconds[0] = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        for(int roll = 0; roll < rolls; roll++){
+            if(roll % randomStreamLength == 0) random.setStream(RandomStream::NATIONAL, repeat, roll / randomStreamLength);
+            total += random.randomIntRange(1, 3);
+        }
+        seconds[1] = secondsSince(start);
+
+        random.setStream(RandomStream::EVENT, repeat, 0);
+        start = chrono::steady_clock::now();
+        for(int roll = 0; roll < rolls; roll++) total += random.standardDeviation(50, 10);
+        seconds[2] = secondsSince(start);
+
+        random.setStream(RandomStream::NATIONAL, repeat, 0);
+        start = chrono::steady_clock::now();
+        for(int roll = 0; roll < rolls; roll += arrayLength){
+            random.randomIntRange(1, 3, values, arrayLength);
+            total += values[roll % arrayLength];
+        }
+        seconds[3] = secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        for(int roll = 0; roll < rolls; roll += randomStreamLength){
+            random.setStream(RandomStream::NATIONAL, repeat, roll / randomStreamLength);
+            random.randomIntRange(1, 3, values, randomStreamLength);
+            total += values[roll % randomStreamLength];
+        }
+        seconds[4] = secondsSince(start);
+
+        for(int x = 0; x < 5; x++){
+            if(best[x] < 0 || seconds[x] < best[x]) best[x] = seconds[x];
+        }
+    }
+
+    printResult("random/randomIntRange", rolls / best[0] / 1e6, "Mdraws/s");
+    printResult("random/randomIntRange/stream=" + to_string(randomStreamLength), rolls / best[1] / 1e6, "Mdraws/s");
+    printResult("random/standardDeviation", rolls / best[2] / 1e6, "Mdraws/s");
+    printResult("random/randomIntRange/array", rolls / best[3] / 1e6, "Mdraws/s");
+    printResult("random/randomIntRange/array/stream=" + to_string(randomStreamLength), rolls / best[4] / 1e6, "Mdraws/s");
+    if(total == 0) cout<<endl;
+}
+
+// function used to benchmark influencing every electorate of an election with the stances of its first candidate
+void benchInfluenceElectorate(uint64_t seed, int repeats){
+
+    Election election(microElectorates, 1, seed, 0, NarrationLevel::SILENT);
+    setUpElection(election, seed);
+
+    VoterStore& voters = election.getVoters();
+    vector<Electorate>& electorates = election.getElectorates();
+    CandidateTable& candidates = election.getCandidates();
+    RandomGenerator random(seed, 0);
+    const int passes = 20;
+
+    double best = -1;
+    for(int repeat = 0; repeat < repeats; repeat++){
+        random.setStream(RandomStream::NATIONAL, repeat, 0);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int pass = 0; pass < passes; pass++){
+            for(Electorate& currentElectorate : electorates){
+                Stance* stances = candidates.getCandidate(currentElectorate.getID(), 0).getStances();
+                currentElectorate.influenceElectorate(voters, stances, pass % 2 == 0, random);
+            }
+        }
+        double seconds = secondsSince(start);
+        if(best < 0 || seconds < best) best = seconds;
+    }
+
+    printResult("influenceElectorate", best * 1e9 / ((double)passes * electorates.size()), "ns/call");
+}
+
+// function used to benchmark the influence of a national event, which influences every cluster of every electorate
+// with the stances of the first candidate of the first electorate
+void benchInfluenceNation(uint64_t seed, int repeats){
+
+    Election election(microElectorates, 1, seed, 0, NarrationLevel::SILENT);
+    setUpElection(election, seed);
+
+    Stance* stances = election.getCandidates().getCandidate(0, 0).getStances();
+    int numOfClusters = election.getVoters().getNumOfClusters();
+    const int passes = 20;
+
+    double best = -1;
+    for(int repeat = 0; repeat < repeats; repeat++){
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int pass = 0; pass < passes; pass++){
+            election.influenceNation(stances, pass % 2 == 0);
+        }
+        double seconds = secondsSince(start);
+        if(best < 0 || seconds < best) best = seconds;
+    }
+
+    printResult("influenceNation", best * 1e9 / ((double)passes * numOfClusters), "ns/cluster");
+}
+
+// function used to benchmark running each event of the catalog, which picks the participants of the event
+// then processes it with processEvent, the electorate it is run in moves on every time it is run.
+// each event is named by its type and its name from the catalog with the spaces replaced
+void benchProcessEvent(uint64_t seed, int repeats){
+
+    const char* typeNames[NUM_OF_EVENT_TYPES] = {"debate", "candidate", "leader", "issue"};
+
+    Election election(microElectorates, 1, seed, 0, NarrationLevel::SILENT);
+    setUpElection(election, seed);
+
+    vector<Electorate>& electorates = election.getElectorates();
+    EventCatalog& events = election.getEvents();
+
+    for(int event = 0; event < events.getNumOfEvents(); event++){
+        double best = -1;
+        for(int repeat = 0; repeat < repeats; repeat++){
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for(int call = 0; call < eventCalls; call++){
+                election.handleEvent(event, &electorates[call % electorates.size()]);
+            }
+            double seconds = secondsSince(start);
+            if(best < 0 || seconds < best) best = seconds;
+        }
+
+        string name = events.getText(events[event].name);
+        replace(name.begin(), name.end(), ' ', '_');
+        printResult(string("processEvent/") + typeNames[static_cast<int>(events[event].type)] + "/" + name, best * 1e9 / eventCalls, "ns/event");
+    }
+}
+
+// function used to benchmark the campaign, a new election is generated for each repeat as the campaign uses up its days
+// the campaign is run on campaignThreads threads in the given order and the number of events run is printed as well,
+// it only changes if the random streams or events change and is the same on any number of threads and in either order
+void benchRunCampaign(uint64_t seed, int repeats, int campaignThreads, CampaignOrder order, const string& name){
+
+    double best = -1;
+    uint64_t numOfEvents = 0;
+    for(int repeat = 0; repeat < repeats; repeat++){
+        Election election(microElectorates, microDays, seed, 0, NarrationLevel::SILENT);
+        setUpElection(election, seed);
+        election.setCampaignThreads(campaignThreads);
+        election.setCampaignOrder(order);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        election.runCampaign();
+        double seconds = secondsSince(start);
+        if(best < 0 || seconds < best) best = seconds;
+
+        ElectionStats& stats = election.getStats();
+        numOfEvents = 0;
+        for(int x = 0; x < NUM_OF_EVENT_TYPES; x++) numOfEvents += stats.eventsByType[x];
+    }
+
+    printResult(name, best * 1e9 / ((double)microElectorates * microDays), "ns/electorate-day");
+    if(STATS_ENABLED) printResult(name + "/events", numOfEvents, "events");
+}
+
+// function used to benchmark branching an election half way through its campaign,
+// fork makes a new election sharing everything that never changes and restore puts a fork back to the snapshot,
+// both are timed per call and only copy the mutable state so they stay far below a generated election
+void benchBranch(uint64_t seed, int repeats){
+
+    Election election(microElectorates, microDays, seed, 0, NarrationLevel::SILENT);
+    setUpElection(election, seed);
+    election.runCampaign(microDays / 2);
+    ElectionSnapshot snapshot = election.snapshot();
+
+    double best[2] = {-1, -1};
+    for(int repeat = 0; repeat < repeats; repeat++){
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int call = 0; call < branchCalls; call++){
+            unique_ptr<Election> branch = election.fork(call);
+        }
+        double seconds = secondsSince(start);
+        if(best[0] < 0 || seconds < best[0]) best[0] = seconds;
+
+        unique_ptr<Election> branch = election.fork(0);
+        start = chrono::steady_clock::now();
+        for(int call = 0; call < branchCalls; call++){
+            branch->restore(snapshot, call);
+        }
+        seconds = secondsSince(start);
+        if(best[1] < 0 || seconds < best[1]) best[1] = seconds;
+    }
+
+    printResult("branch/fork", best[0] * 1e6 / branchCalls, "us/fork");
+    printResult("branch/restore", best[1] * 1e6 / branchCalls, "us/restore");
+}
+
+// function used to benchmark whole elections, generating, campaigning and tallying, as a batch
+// at 10, 1000 and 100000 electorates on 1, 8 and all hardware threads.
+// every size runs the same number of elections on each number of threads so the times show how the batch scales
+void benchEndToEnd(uint64_t seed, int repeats, int maxElectorates){
+
+    const int sizes[3] = {10, 1000, 100000};
+    const int runs[3] = {512, 32, 8};
+    int hardwareThreads = max(1, (int)thread::hardware_concurrency());
+    const int threads[3] = {1, 8, hardwareThreads};
+    const char* threadNames[3] = {"1", "8", "all"};
+
+    ScenarioSpec scenario;
+    scenario.parse(benchScenario, seed);
+
+    for(int size = 0; size < 3; size++){
+        if(sizes[size] > maxElectorates) continue;
+
+        for(int x = 0; x < 3; x++){
+            double best = -1;
+            for(int repeat = 0; repeat < repeats; repeat++){
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                BatchSimulator batch(sizes[size], endToEndDays, runs[size], threads[x], seed);
+                batch.setScenario(scenario);
+                batch.runBatch();
+                double seconds = secondsSince(start);
+                if(best < 0 || seconds < best) best = seconds;
+            }
+
+            printResult("endToEnd/electorates=" + to_string(sizes[size]) + "/threads=" + threadNames[x], best * 1e3 / runs[size], "ms/election");
+        }
+    }
+}
+
+// Main function which collects the arguments upon execution and runs every benchmark
+// the seed is fixed unless one is provided so the same events are run every time
+int main(int argle, char* argv[]){
+
+    uint64_t seed = 1;
+    int repeats = 3;
+    int maxElectorates = 100000;
+
+    if(argle % 2 == 0){
+        cerr<<"Please enter valid arguments:\n./<bench exe> [--seed <seed>] [--repeats <number of repeats>] [--max-electorates <number of electorates>]"<<endl;
+        return 1;
+    }
+
+    for(int x = 1; x < argle; x += 2){
+        string option = argv[x];
+        if(option == "--seed") seed = stoull(argv[x + 1]);
+        else if(option == "--repeats") repeats = stoi(argv[x + 1]);
+        else if(option == "--max-electorates") maxElectorates = stoi(argv[x + 1]);
+        else{
+            cerr<<"Unknown option "<<option<<endl;
+            return 1;
+        }
+    }
+
+    if(repeats < 1){
+        cerr<<"Number of repeats must be at least 1."<<endl;
+        return 1;
+    }
+
+    // the best time of the repeats is printed for each benchmark
+    cout<<"# Election Simulator benchmarks, format "<<benchFormatVersion<<endl;
+    cout<<"# seed "<<seed<<", repeats "<<repeats<<", hardware threads "<<thread::hardware_concurrency()<<endl;
+
+    benchRandom(seed, repeats);
+    benchCountStancesWon(seed, repeats);
+    benchTallyVotes(seed, repeats);
+    benchCharacteristics(seed, repeats);
+    benchInfluenceElectorate(seed, repeats);
+    benchInfluenceNation(seed, repeats);
+    benchProcessEvent(seed, repeats);
+    benchRunCampaign(seed, repeats, 1, CampaignOrder::DAY_MAJOR, "runCampaign");
+    benchRunCampaign(seed, repeats, 1, CampaignOrder::ELECTORATE_MAJOR, "runCampaign/order=electorate");
+    benchRunCampaign(seed, repeats, 8, CampaignOrder::DAY_MAJOR, "runCampaign/campaignThreads=8");
+    benchRunCampaign(seed, repeats, max(1, (int)thread::hardware_concurrency()), CampaignOrder::DAY_MAJOR, "runCampaign/campaignThreads=all");
+    benchBranch(seed, repeats);
+    benchEndToEnd(seed, repeats, maxElectorates);
+
+    return 0;
+}
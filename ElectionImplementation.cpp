@@ -6,29 +6,100 @@
 #include <ostream>
 #include <random>
 #include <vector>
-#include <map>
 #include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
 #include "ElectionLibrary.h"
 
+// the vector kernels are built for x86 with the instruction sets picked when the program starts
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ELECTION_VECTOR_KERNELS
+#endif
+
+// scenario files are memory mapped where mmap is available, otherwise they are read into memory
+#if defined(__unix__) || defined(__APPLE__)
+#define ELECTION_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 
+// the number of clusters the vote tally counts the stances won for at a time
+static const int clustersPerBlock = 4096;
+
+// the width of the names in front of each row of the stance tables of parties and electorates
+static const int candidateLabelWidth = 28;
+static const int clusterLabelWidth = 33;
+
+// what the event of an electorate changed when it was run by a campaign worker, kept in Election::dayChanges
+static const uint8_t clustersChanged = 1;
+static const uint8_t candidatePopularityChanged = 2;
+
+// the fewest electorates in each chunk handed out by the campaign scheduler
+// and how many chunks each worker is given to start with so there are chunks left to steal
+static const int minCampaignChunk = 16;
+static const int campaignChunksPerWorker = 8;
+
+// the most clusters in each block of electorates the electorate major campaign runs every day for,
+// small enough that the stances of the block stay in the cache
+static const int campaignBlockClusters = 8192;
+
+// the most rolls an influence draws from the generator at once, enough for a few clusters on every issue
+static const int influenceRolls = 256;
+// the most rolls an influence moves the approaches of the clusters by at once, an issue at a time
+static const int influenceBlockRolls = 16384;
+
 /*  Start of Election functions */
 
 //Election constructor which takes numOfElectorates and numOfDays
-Election::Election(int electorates, int days){
+// electionSeed and runNumber are used to key the elections random streams
+// narrationLevel is how much of the election is narrated, nothing is printed when it is SILENT
+Election::Election(int electorates, int days, uint64_t electionSeed, uint32_t electionRun, NarrationLevel narrationLevel) : random(electionSeed, electionRun), narration(narrationLevel){
     numOfElectorates = electorates;
     numOfDays = days;
+    seed = electionSeed;
+    runNumber = electionRun;
+    journal = nullptr;
+    projectionBuilt = false;
+    pollOutput = nullptr;
+    winningParty = -1;
+    hungParliament = false;
+    campaignDay = 0;
+    campaignThreads = 1;
+    campaignOrder = CampaignOrder::DAY_MAJOR;
+    campaignScheduler = nullptr;
+    nationalStances = nullptr;
+    nationalPositive = false;
+    campaignDraws = 0;
+    stats.elections = 1;
 }
 
 // function used to generate/load all data used within the election.
 void Election::generateElection(){
 
-    loadIssues(); // loads all issues
+    STATS_PHASE(stats, StatsPhase::GENERATE);
+
     loadEvents(); // loads all events
-    loadElectorates(); // loads all electorates
-    generateElectorateClusters(); // generates clusters for electorates
-    calculateElectoratePop(); // calculates the total pop of each electorate
-    generateParties(); // generates parties
+    if(!scenario.scenarioFile.empty()) loadScenarioFile(); // loads the issues, electorates, clusters, parties and candidates from a scenario file
+    else{
+        if(scenario.numOfIssues > 0) generateScenarioIssues(); // generates the issues for the scenario
+        else loadIssues(); // loads all issues
+        voters.setNumOfIssues(issues.getNumOfIssues()); // sets up a stance array in the voter store for each issue
+        if(scenario.generated) generateScenarioElectorates(); // generates all electorates from the scenario
+        else loadElectorates(); // loads all electorates
+        generateElectorateClusters(); // generates clusters for electorates
+        calculateElectoratePop(); // calculates the total pop of each electorate
+        generateParties(); // generates parties
+    }
+    setUpTally(); // allocates everything used by the vote tally
 
 }
 
@@ -37,13 +108,258 @@ void Election::generateElection(){
 void Election::runElection(){
     runCampaign(); // runs the campaign simulation
     calculatePopularity(); // calculates popularity after campaign
-    reportElection(); // reports on the election
+    // reports on the election, only when fully narrating
+    // the report is printed straight to cout so the narration is written out first
+    if(narration.isEnabled(NarrationLevel::FULL)){
+        narration.flush();
+        reportElection();
+    }
+}
+
+// function used to rebuild the campaign from a journal instead of simulating it
+// then runs the same post campaign functions as runElection.
+// returns false without changing the election if the journal doesn't fit it
+bool Election::replayElection(EventJournal& replayJournal){
+    if(!validateJournal(replayJournal)) return false;
+    replayCampaign(replayJournal); // applies every event of the journal
+    calculatePopularity(); // calculates popularity after campaign
+    if(narration.isEnabled(NarrationLevel::FULL)){
+        narration.flush();
+        reportElection();
+    }
+    return true;
+}
+
+// function used to check every record of a journal can be replayed on the election
+// the parties of the characteristic changes have to be in the election and hold the characteristic changed,
+// stance changes have to be for one of its issues and each record has to hold a stance change for every
+// cluster and issue its influence goes through, as many as replayInfluence will read.
+// prints what is wrong with the first record that can't be replayed and returns false
+bool Election::validateJournal(EventJournal& replayJournal){
+
+    int64_t numOfIssues = voters.getNumOfIssues();
+
+    for(uint64_t index = 0; index < replayJournal.records.size(); index++){
+        EventRecord& record = replayJournal.records[index];
+
+        if(record.electorate >= (int)electorates.size()){
+            cerr<<"Journal record "<<index<<" is for electorate "<<record.electorate<<" but the election only has "<<electorates.size()<<endl;
+            return false;
+        }
+
+        for(int x = 0; x < record.numOfCharChanges; x++){
+            CharacteristicChange& charChange = record.charChanges[x];
+            if(charChange.party < 0 || charChange.party >= (int)parties.size()){
+                cerr<<"Journal record "<<index<<" changes party "<<(int)charChange.party<<" but the election only has "<<parties.size()<<endl;
+                return false;
+            }
+            Candidate& person = charChange.leader ? parties[charChange.party].getLeader() : candidates.getCandidate(record.electorate, charChange.party);
+            if(!person.hasChar(static_cast<Characteristic>(charChange.characteristic))){
+                cerr<<"Journal record "<<index<<" changes "<<static_cast<Characteristic>(charChange.characteristic)<<" of "<<person.getName()<<" who doesn't have it"<<endl;
+                return false;
+            }
+        }
+
+        int64_t expectedDeltas = 0;
+        int64_t electorateClusters = electorates[record.electorate].getNumOfClusters();
+        if(record.influence == EventInfluence::ELECTORATE) expectedDeltas = electorateClusters * numOfIssues;
+        else if(record.influence == EventInfluence::STANCE){
+            if(record.issue >= numOfIssues){
+                cerr<<"Journal record "<<index<<" changes issue "<<(int)record.issue<<" but the election only has "<<numOfIssues<<endl;
+                return false;
+            }
+            expectedDeltas = electorateClusters;
+        }
+        else if(record.influence == EventInfluence::NATIONAL) expectedDeltas = (int64_t)voters.getNumOfClusters() * numOfIssues;
+
+        if(record.numOfStanceDeltas != expectedDeltas){
+            cerr<<"Journal record "<<index<<" holds "<<record.numOfStanceDeltas<<" stance changes but its influence makes "<<expectedDeltas<<endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// function used to apply every event recorded in a journal to the election
+// the characteristic and stance changes of each event are applied in the order they were made
+// so the election ends up in the same state as after runCampaign, without any random rolls.
+// The election has to be generated from the same seed and scenario as the journal.
+void Election::replayCampaign(EventJournal& replayJournal){
+
+    STATS_PHASE(stats, StatsPhase::CAMPAIGN);
+
+    narration.narrate(NarrationLevel::DAILY, "~~~~~~~~~~~~~~~~~~~~~~~~~~~REPLAYING CAMPAIGN~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+
+    const int8_t* stanceDeltas = replayJournal.stanceDeltas.data();
+    int polledDay = 0; // last day a poll was written for
+
+    if(pollOutput) writePollHeader();
+
+    for(EventRecord& record : replayJournal.records){
+
+        // the days before the day of the record are finished so they are polled
+        while(pollOutput && polledDay < record.day - 1) writePoll(++polledDay);
+
+        for(int x = 0; x < record.numOfCharChanges; x++){
+            CharacteristicChange& charChange = record.charChanges[x];
+            Candidate& person = charChange.leader ? parties[charChange.party].getLeader() : candidates.getCandidate(record.electorate, charChange.party);
+            person.updateChar(static_cast<Characteristic>(charChange.characteristic), charChange.change);
+            if(!charChange.leader && static_cast<Characteristic>(charChange.characteristic) == Characteristic::POPULARITY) markElectorateDirty(record.electorate);
+        }
+
+        const int8_t* changes = stanceDeltas + record.firstStanceDelta;
+
+        // the event code is the index of the event in the catalog the journal was recorded with
+        if(record.eventCode < events.getNumOfEvents()) STATS_ADD(stats.eventsByType[static_cast<int>(events[record.eventCode].type)], 1);
+
+        if(record.influence == EventInfluence::ELECTORATE){
+            electorates[record.electorate].replayInfluence(voters, changes, -1);
+            STATS_ADD(stats.influenceCalls, 1);
+            STATS_ADD(stats.clustersTouched, electorates[record.electorate].getNumOfClusters());
+        }
+        else if(record.influence == EventInfluence::STANCE){
+            electorates[record.electorate].replayInfluence(voters, changes, record.issue);
+            STATS_ADD(stats.influenceCalls, 1);
+            STATS_ADD(stats.clustersTouched, electorates[record.electorate].getNumOfClusters());
+        }
+        else if(record.influence == EventInfluence::NATIONAL){
+            for(Electorate& currentElectorate : electorates){
+                changes += currentElectorate.replayInfluence(voters, changes, -1);
+            }
+            STATS_ADD(stats.influenceCalls, electorates.size());
+            STATS_ADD(stats.clustersTouched, voters.getNumOfClusters());
+        }
+
+        campaignDay = record.day;
+    }
+
+    while(pollOutput && polledDay < numOfDays) writePoll(++polledDay);
+
+    numOfDays = 0;
+
+    narration.narrate(NarrationLevel::DAILY, "%d events were replayed\n", (int64_t)replayJournal.records.size());
+    narration.narrate(NarrationLevel::DAILY, "~~~~~~~~~~~~~~~~~~~~~~~~~~~CAMPAIGNING HAS FINISHED~~~~~~~~~~~~~~~~~~~~~~~~~~~\n\n");
+}
+
+// function used to set how many threads run the campaign
+// the campaign is only run in parallel when it isn't narrated daily or journaled, the results are the same either way.
+void Election::setCampaignThreads(int threads){
+    campaignThreads = max(1, threads);
+}
+
+// function used to set the order the days and electorates of the campaign are run in
+// the electorate major order is only used when the campaign isn't narrated daily, journaled, polled or run in parallel
+// and every event that changes more than its own electorate is a leader event, the results are the same either way.
+void Election::setCampaignOrder(CampaignOrder order){
+    campaignOrder = order;
+}
+
+// function used to set the journal the events of the campaign are recorded in
+// the header of the journal is filled in so the election can be generated again when replaying.
+void Election::setJournal(EventJournal* newJournal){
+    journal = newJournal;
+
+    if(journal){
+        journal->seed = seed;
+        journal->runNumber = runNumber;
+        journal->numOfElectorates = numOfElectorates;
+        journal->numOfDays = numOfDays;
+        journal->scenario = scenario;
+    }
+}
+
+// function used to set where the daily polls are written, nullptr stops the polls
+void Election::setPollOutput(ostream* output){
+    pollOutput = output;
+}
+
+// function used to write the column names of the polls, the seats of each party then the vote share of each party
+void Election::writePollHeader(){
+
+    *pollOutput<<"day";
+    for(Party& currentParty : parties){
+        *pollOutput<<","<<currentParty.getName()<<" seats";
+    }
+    for(Party& currentParty : parties){
+        *pollOutput<<","<<currentParty.getName()<<" share";
+    }
+    *pollOutput<<"\n"<<fixed<<setprecision(4);
+}
+
+// function used to write the poll for a day of the campaign as one row
+// the poll is the current projection so it only costs as much as the changes made since the last poll.
+void Election::writePoll(int day){
+
+    Projection& poll = currentProjection();
+
+    *pollOutput<<day;
+    for(int seats : poll.seats){
+        *pollOutput<<","<<seats;
+    }
+    for(int64_t votes : poll.votes){
+        *pollOutput<<","<<(poll.totalVotes > 0 ? (double)votes / poll.totalVotes : 0.0);
+    }
+    *pollOutput<<"\n";
+}
+
+// function used to start the record of an event before it is run
+// when journaling the voter store adds every stance change of the event to the journal
+void Election::startRecord(int day, int elecIndex, int event){
+
+    currentRecord = EventRecord();
+    currentRecord.day = day;
+    currentRecord.electorate = elecIndex;
+    currentRecord.eventCode = events[event].code;
+    currentRecord.influence = EventInfluence::NONE;
+    currentRecord.participants[0] = -1;
+    currentRecord.participants[1] = -1;
+    currentRecord.winner = -1;
+
+    if(journal){
+        currentRecord.firstStanceDelta = journal->stanceDeltas.size();
+        voters.setChangeLog(&journal->stanceDeltas);
+    }
+}
+
+// function used to add the record of the event that has just been run to the journal
+void Election::finishRecord(){
+
+    if(!journal) return;
+
+    voters.setChangeLog(nullptr);
+    currentRecord.numOfStanceDeltas = journal->stanceDeltas.size() - currentRecord.firstStanceDelta;
+    journal->records.push_back(currentRecord);
+}
+
+// function used to update the characteristic of a candidate or leader during an event
+// the change is kept in the record of the event so it can be replayed.
+void Election::updateCandidateChar(Candidate* person, Characteristic chr, int value, EventContext& context){
+
+    EventRecord& record = *context.record;
+    if(record.numOfCharChanges < MAX_CHARACTERISTIC_CHANGES){
+        CharacteristicChange& charChange = record.charChanges[record.numOfCharChanges++];
+        charChange.party = person->getRelatedParty()->getID();
+        charChange.leader = person->getElectorateID() == -1;
+        charChange.characteristic = static_cast<underlying_type<Characteristic>::type>(chr);
+        charChange.change = value;
+    }
+
+    // the projection has to count the candidates electorate again when their popularity changes
+    // when the electorate is run by a campaign worker it is marked once the worker has finished
+    if(chr == Characteristic::POPULARITY && person->getElectorateID() != -1){
+        if(context.deferDirty) context.popularityChanged = true;
+        else markElectorateDirty(person->getElectorateID());
+    }
+
+    person->updateChar(chr, value);
 }
 
 // function used to run all functions which wrap up the election
 void Election::finishElection(){
     tallyVotes(); // calculates and tally's the votes for each electorate
     determineWinner(); // determines winner and prints results
+    narration.flush(); // the results are written out before anything else is printed
 }
 
 // function used to run functions for loading leaders and the stance ranges
@@ -51,35 +367,79 @@ void Election::finishElection(){
 // also ensures each party leader has pointer assigned to their own party
 void Election::generateParties(){
 
-    loadLeadersAndStanceRange(); // loads party leaders, generates parties, loads stance ranges
+    if(scenario.numOfParties > 0) generateScenarioParties(); // generates the parties, leaders and stance ranges for the scenario
+    else loadLeadersAndStanceRange(); // loads party leaders, generates parties, loads stance ranges
     generateCandidates(); // generates candidates for each party.
 
     // sets the leaders related party to the party that they're leading
-    parties[0].getLeader().setRelatedParty(&parties[0]);
-    parties[1].getLeader().setRelatedParty(&parties[1]);
-    parties[2].getLeader().setRelatedParty(&parties[2]);
+    for(Party& party : parties){
+        party.getLeader().setRelatedParty(&party);
+    }
 
 }
 
-// function used to load the individual issues and add them to the issues vector
+// function used to load the individual issues from Issues.txt and add them to the issue registry
+// each line is the type of the issue, its code and then its statement.
+// the id of each issue is the order it was added in.
 void Election::loadIssues(){
-    issues.push_back(Issue("COVID-19 Financial Situation", "The financial situation caused by COVID-19 to Australia's population which is having a huge impact to businesses and families.", IssueType::ECONOMIC));
-    issues.push_back(Issue("Sauce Debate","The ongoing debate of whether tomato sauce belongs in the fridge or cupboard which has the nation divided.", IssueType::SOCIAL));
-    issues.push_back(Issue("Toilet Paper Shortage","The national toilet paper shortage causing unrest with the nation.", IssueType::LOGISTICS));
-    issues.push_back(Issue("Global Warming","The ongoing issue of Global warming and how to best handle ongoing affairs for it.", IssueType::ENVIRONMENTAL));
-    issues.push_back(Issue("Mandatory Vaccines","COVID-19 mandatory vaccines.", IssueType::HEALTH));
+
+    ifstream issueFile;
+    string line;
+
+    issueFile.open("Issues.txt");
+
+    if(issueFile.bad() || !issueFile.is_open()){
+        cerr<<"Issues file was unable to be opened"<<endl;
+        exit(1);
+    }
+
+    while(getline(issueFile, line)){
+
+        stringstream lineStream(line);
+        string type, code, statement;
+        IssueType issueType;
+
+        getline(lineStream, type, ',');
+        getline(lineStream, code, ',');
+        getline(lineStream, statement);
+
+        if(type == "economic") issueType = IssueType::ECONOMIC;
+        else if(type == "social") issueType = IssueType::SOCIAL;
+        else if(type == "logistics") issueType = IssueType::LOGISTICS;
+        else if(type == "environmental") issueType = IssueType::ENVIRONMENTAL;
+        else if(type == "health") issueType = IssueType::HEALTH;
+        else{
+            cerr<<"Unknown issue type "<<type<<" in Issues.txt, use economic, social, logistics, environmental or health"<<endl;
+            exit(1);
+        }
+
+        issues.internIssue(code, statement, issueType);
+    }
+
+    issueFile.close();
+
+    if(issues.getNumOfIssues() < MIN_ISSUES || issues.getNumOfIssues() > MAX_ISSUES){
+        cerr<<"Issues.txt must have "<<MIN_ISSUES<<" - "<<MAX_ISSUES<<" issues"<<endl;
+        exit(1);
+    }
+}
+
+// function used to generate the issues of a generated scenario instead of loading Issues.txt
+// each issue is named by its number and the issue types are used in turn.
+void Election::generateScenarioIssues(){
+
+    const int numOfIssueTypes = 5;
+
+    for(int issue = 0; issue < scenario.numOfIssues; issue++){
+        string code = "Issue " + to_string(issue + 1);
+        issues.internIssue(code, "The generated issue number " + to_string(issue + 1) + ".", static_cast<IssueType>(issue % numOfIssueTypes));
+    }
 }
 
-// function used to load the individual events and add them to the events vector
-// the statements for events are dynamic and candidate names will be entered upon printing the statements.
+// function used to load the event catalog from the event file of the scenario
+// the events are compiled into dispatch records when they are loaded.
 void Election::loadEvents(){
-    events.push_back(Event(EventType::DEBATE, "%s & %s have decided to have a debate\n", 6, Characteristic::DEBATING));
-    events.push_back(Event(EventType::CANDIDATE_RELATED, "Oh no! %s has been involved in a scandal!\n", 10, Characteristic::POPULARITY));
-    events.push_back(Event(EventType::CANDIDATE_RELATED, "%s has played a prank on another candidate\n", 5, Characteristic::POPULARITY));
-    events.push_back(Event(EventType::LEADER_RELATED, "The Party Leaders %s & %s have decided to have a friendly boxing match in %s \n", 10, Characteristic::POPULARITY));
-    events.push_back(Event(EventType::LEADER_RELATED, "The Party Leaders %s & %s have decided to have a have a debate in %s today!\n", 10, Characteristic::POPULARITY));
-    events.push_back(Event(EventType::ISSUE_RELATED, "%s has observed how other countries are handling the %s issue.\n", 7, Characteristic::POPULARITY));
-    events.push_back(Event(EventType::ISSUE_RELATED, "Some new information has been released on the %s issue by %s\n", 5, Characteristic::POPULARITY));
+    events.load(scenario.eventFile);
 }
 
 // function used to load electorates from Electorates.txt and add each electorate to the
@@ -102,29 +462,68 @@ void Election::loadElectorates(){
 
         stringstream lineStream(line);
         string electorateName, pop;
-        int totalPopulation;
+        int64_t totalPopulation;
 
         getline(lineStream, electorateName, ',');
         getline(lineStream, pop);
 
-        totalPopulation = stoi(pop);
+        totalPopulation = stoll(pop);
 
 
-        electorates.push_back(Electorate(issues, electorateName, totalPopulation));
+        electorates.push_back(Electorate(electorates.size(), electorateName, totalPopulation));
     }
 
     electorateFile.close();
 
 }
 
+// function used to generate the electorates for a scenario instead of loading Electorates.txt
+// each electorate is named by its number and its population is picked from the
+// scenarios population distribution using the scenario seed.
+void Election::generateScenarioElectorates(){
+
+    RandomGenerator scenarioRandom(scenario.seed, 0);
+
+    // the smallest population an electorate can have so every cluster gets at least 1 vote for each stance it gives,
+    // the smallest cluster is 1/8 of the electorate and its votes are split between up to MAX_ISSUES stances
+    const int64_t minPopulation = 8 * MAX_ISSUES;
+
+    electorates.reserve(numOfElectorates);
+
+    for(int elecIndex = 0; elecIndex < numOfElectorates; elecIndex++){
+
+        scenarioRandom.setStream(RandomStream::GENERATION, 0, elecIndex);
+
+        int64_t totalPopulation;
+        if(scenario.distribution == "uniform") totalPopulation = scenarioRandom.randomIntRange64(scenario.first, scenario.second);
+        else totalPopulation = scenarioRandom.standardDeviation64(scenario.first, scenario.second);
+
+        if(totalPopulation < minPopulation) totalPopulation = minPopulation;
+        else if(totalPopulation > MAX_ELECTORATE_POPULATION) totalPopulation = MAX_ELECTORATE_POPULATION;
+
+        electorates.push_back(Electorate(elecIndex, "Electorate " + to_string(elecIndex + 1), totalPopulation));
+    }
+}
+
+// function used to set the scenario used to generate the electorates and candidates
+void Election::setScenario(ScenarioSpec newScenario){
+    scenario = newScenario;
+}
+
 // function used to generate clusters for each electorate.
 void Election::generateElectorateClusters(){
 
+    // each electorate has 4 clusters
+    voters.reserve(electorates.size() * 4);
+
     // for loop to run through each electorate.
-    for(Electorate &currentElectorate: electorates){
+    // each electorate is generated from its own random stream
+    for(unsigned int elecIndex = 0; elecIndex < electorates.size(); elecIndex++){
 
-        RandomGenerator random;
-        int minPop, maxPop, pop;
+        Electorate &currentElectorate = electorates[elecIndex];
+        int64_t minPop, maxPop, pop;
+
+        random.setStream(RandomStream::GENERATION, 0, elecIndex);
 
         // gets the totalpop from the current electorate which is based off
         // total pop in the electorates.txt file
@@ -140,7 +539,7 @@ void Election::generateElectorateClusters(){
             // creates Electorate cluster by using range inbetween minpop and maxpop
             // this is provided by using the randomIntRange function.
             // This range ensures that total pop of 4 clusters does not go above the original totalpop
-            currentElectorate.addCluster(ElectorateCluster(random.randomIntRange(minPop, maxPop)));
+            currentElectorate.addCluster(voters.addCluster(elecIndex, random.randomIntRange64(minPop, maxPop)));
         }
 
         // Variables used to for the min max range of the approach and significance of stances
@@ -154,13 +553,14 @@ void Election::generateElectorateClusters(){
         // After clusters are generated and added to the electorate
         // we use this for loop to run through each electorate and generate
         // individual stances for each issue for each cluster.
-        for(ElectorateCluster &currentCluster : currentElectorate.getClusters()){
-            for(Issue &currentIssue : issues){
+        int lastCluster = currentElectorate.getFirstCluster() + currentElectorate.getNumOfClusters();
+        for(int cluster = currentElectorate.getFirstCluster(); cluster < lastCluster; cluster++){
+            for(int issue = 0; issue < issues.getNumOfIssues(); issue++){
 
-                Issue newIssue(currentIssue);
-                Stance newStance(newIssue, random.randomIntRange(sigMin, sigMax), random.randomIntRange(appMin, appMax));
+                int approach = random.randomIntRange(appMin, appMax);
+                int significance = random.randomIntRange(sigMin, sigMax);
 
-                currentCluster.addStance(newStance);
+                voters.setStance(cluster, issue, significance, approach);
 
             }
         }
@@ -174,9 +574,10 @@ void Election::generateElectorateClusters(){
 void Election::calculateElectoratePop(){
 
     for(Electorate &currentElectorate : electorates){
-        unsigned int pop = 0;
-        for(ElectorateCluster &currentCluster : currentElectorate.getClusters()){
-            pop += currentCluster.getPopulation();
+        int64_t pop = 0;
+        int lastCluster = currentElectorate.getFirstCluster() + currentElectorate.getNumOfClusters();
+        for(int cluster = currentElectorate.getFirstCluster(); cluster < lastCluster; cluster++){
+            pop += voters.getPopulation(cluster);
         }
         currentElectorate.setPopulation(pop);
 
@@ -205,32 +606,170 @@ void Election::loadLeadersAndStanceRange(){
     while(getline(leaderFile, line)){
 
         stringstream lineStream(line);
-        string leaderName, partyName, nextNum;
+        string leaderName, partyName, description, nextNum;
         int num;
-        int ranges[5][4];
+        vector<StanceRange> ranges(issues.getNumOfIssues());
 
         getline(lineStream, partyName, ',');
         getline(lineStream, leaderName, ',');
 
-        for(int x = 0; x < 5; x++){
+        // each issue has 4 numbers for its stance range
+        for(int x = 0; x < issues.getNumOfIssues(); x++){
             for(int y = 0; y < 4; y++){
-                getline(lineStream, nextNum, ',');
+                if(!getline(lineStream, nextNum, ',') || nextNum.empty() || nextNum.find_first_not_of("0123456789") != string::npos){
+                    cerr<<"The stance ranges of "<<partyName<<" in Leaders.txt don't match the "<<issues.getNumOfIssues()<<" issues"<<endl;
+                    exit(1);
+                }
                 num = stoi(nextNum);
                 ranges[x][y] = num;
             }
         }
 
-        // creates the leader from the information collected
-        Candidate newLeader(leaderName, ranges, issues);
-
-        // creates a party using the new leader and ranges collected from the file
-        Party newParty(partyName, newLeader, ranges);
+        // the rest of the line is the description of the party, which can have commas in it
+        getline(lineStream, description);
+        if(!description.empty() && isdigit((unsigned char)description[0])){
+            cerr<<"The stance ranges of "<<partyName<<" in Leaders.txt don't match the "<<issues.getNumOfIssues()<<" issues"<<endl;
+            exit(1);
+        }
 
-        // adds the party to the parties vector
-        parties.push_back(newParty);
+        addParty(partyName, leaderName, description, ranges);
     }
 
     leaderFile.close();
+
+    if(parties.size() < 2 || parties.size() > MAX_PARTIES){
+        cerr<<"Leaders.txt must have 2 - "<<MAX_PARTIES<<" parties"<<endl;
+        exit(1);
+    }
+}
+
+// function used to generate the parties of a generated scenario instead of loading Leaders.txt
+// each party is named by its number and the stance ranges of every issue are picked
+// using the scenario seed so the same map keeps the same parties.
+void Election::generateScenarioParties(){
+
+    RandomGenerator scenarioRandom(scenario.seed, 0);
+
+    for(int partyIndex = 0; partyIndex < scenario.numOfParties; partyIndex++){
+
+        // the electorates use the generation streams of day 0 so each party uses the day after its index
+        scenarioRandom.setStream(RandomStream::GENERATION, partyIndex + 1, 0);
+
+        // each issue has a significance range within 1 - 9 then an approach range within 0 - 100
+        vector<StanceRange> ranges(issues.getNumOfIssues());
+        for(int issue = 0; issue < issues.getNumOfIssues(); issue++){
+            ranges[issue][0] = scenarioRandom.randomIntRange(1, 9);
+            ranges[issue][1] = scenarioRandom.randomIntRange(ranges[issue][0], 9);
+            ranges[issue][2] = scenarioRandom.randomIntRange(0, 100);
+            ranges[issue][3] = scenarioRandom.randomIntRange(ranges[issue][2], 100);
+        }
+
+        string partyName = "Party " + to_string(partyIndex + 1);
+        addParty(partyName, partyName + " Leader", "", ranges);
+    }
+}
+
+// function used to generate a party and its leader and add it to the parties vector
+// each leader and their managerial team are generated from their own random stream
+void Election::addParty(const string& partyName, const string& leaderName, const string& description, const vector<StanceRange>& ranges){
+
+    random.setStream(RandomStream::LEADER, parties.size(), 0);
+
+    // creates the leader from the information collected
+    Candidate newLeader(leaderName, ranges, issues, random);
+
+    // creates a party using the new leader and ranges collected from the file
+    Party newParty(parties.size(), partyName, description, newLeader, ranges, random);
+
+    // adds the party to the parties vector
+    parties.push_back(newParty);
+}
+
+// function used to generate the candidate of a party for an electorate and add it to the candidate table
+// each candidate is generated from their own random stream using the party index in place of the day
+void Election::addCandidate(int elecIndex, Party& party, const string& candidateName){
+
+    random.setStream(RandomStream::CANDIDATE, party.getID(), elecIndex);
+    Candidate newCandidate(elecIndex, candidateName, *party.stanceRanges, issues, random);
+    newCandidate.setRelatedParty(&party);
+    candidates.setCandidate(elecIndex, party.getID(), newCandidate);
+}
+
+// function used to load the electorates, clusters, parties and candidates from a binary scenario file
+// the first numOfElectorates electorates of the file are used, the tables of the file are copied straight
+// into the election without being parsed. The leaders and candidates are generated from the
+// parties stance ranges the same way as when they are loaded from the text files.
+void Election::loadScenarioFile(){
+
+    ScenarioFile scenarioFile;
+
+    if(!scenarioFile.open(scenario.scenarioFile)){
+        cerr<<"Scenario file "<<scenario.scenarioFile<<" was unable to be opened or is not a valid scenario file"<<endl;
+        exit(1);
+    }
+
+    const ScenarioHeader& header = scenarioFile.getHeader();
+    const ScenarioElectorate* scenarioElectorates = scenarioFile.getElectorates();
+
+    if((uint64_t)numOfElectorates > header.numOfElectorates){
+        cerr<<"Scenario file "<<scenario.scenarioFile<<" only has "<<header.numOfElectorates<<" electorates"<<endl;
+        exit(1);
+    }
+
+    for(uint32_t issue = 0; issue < header.numOfIssues; issue++){
+        const ScenarioIssue& scenarioIssue = scenarioFile.getIssues()[issue];
+        issues.internIssue(scenarioFile.getText(scenarioIssue.code), scenarioFile.getText(scenarioIssue.statement), static_cast<IssueType>(scenarioIssue.type));
+    }
+    voters.setNumOfIssues(issues.getNumOfIssues());
+
+    electorates.reserve(numOfElectorates);
+    for(int elecIndex = 0; elecIndex < numOfElectorates; elecIndex++){
+        const ScenarioElectorate& scenarioElectorate = scenarioElectorates[elecIndex];
+        electorates.push_back(Electorate(elecIndex, scenarioFile.getText(scenarioElectorate.name), 0));
+        electorates.back().setClusters(scenarioElectorate.firstCluster, scenarioElectorate.numOfClusters);
+    }
+
+    // the clusters of the electorates used are the first clusters of the file
+    int numOfClusters = scenarioElectorates[numOfElectorates - 1].firstCluster + scenarioElectorates[numOfElectorates - 1].numOfClusters;
+    vector<const int16_t*> approaches, significances;
+    for(int issue = 0; issue < issues.getNumOfIssues(); issue++){
+        approaches.push_back(scenarioFile.getApproaches(issue));
+        significances.push_back(scenarioFile.getSignificances(issue));
+    }
+    voters.addClusters(numOfClusters, scenarioFile.getPopulations(), scenarioFile.getClusterElectorates(), approaches.data(), significances.data());
+
+    calculateElectoratePop();
+
+    for(uint32_t partyIndex = 0; partyIndex < header.numOfParties; partyIndex++){
+        const ScenarioParty& scenarioParty = scenarioFile.getParties()[partyIndex];
+        const int32_t* scenarioRanges = scenarioFile.getStanceRanges(partyIndex);
+        vector<StanceRange> ranges(header.numOfIssues);
+        for(uint32_t issue = 0; issue < header.numOfIssues; issue++){
+            for(int range = 0; range < 4; range++){
+                ranges[issue][range] = scenarioRanges[issue * 4 + range];
+            }
+        }
+        addParty(scenarioFile.getText(scenarioParty.name), scenarioFile.getText(scenarioParty.leaderName), scenarioFile.getText(scenarioParty.description), ranges);
+    }
+
+    candidates.resize(electorates.size(), parties.size());
+    const uint32_t* candidateNames = scenarioFile.getCandidateNames();
+    for(Party& party : parties){
+        for(int elecIndex = 0; elecIndex < numOfElectorates; elecIndex++){
+            addCandidate(elecIndex, party, scenarioFile.getText(candidateNames[elecIndex * header.numOfParties + party.getID()]));
+        }
+    }
+
+    // sets the leaders related party to the party that they're leading
+    for(Party& party : parties){
+        party.getLeader().setRelatedParty(&party);
+    }
+}
+
+// function used to write the electorates, clusters, parties and candidates of the election to a binary scenario file
+// so they can be loaded again without generating or parsing them. returns false if the file couldn't be written
+bool Election::writeScenarioFile(const string& fileName){
+    return ScenarioFile::write(fileName, issues, parties, electorates, voters, candidates);
 }
 
 // function used to generate candidates for each party using their respective candidate .txt file
@@ -240,33 +779,40 @@ void Election::generateCandidates(){
     string fileName;
     string candidateName;
 
+    candidates.resize(electorates.size(), parties.size());
+
     // for loop used to run through each party
     for(Party& party : parties){
 
-        // if statements used to determine which file to load the candidates from based on the party name
-        if(party.getName() == "Labor Party") fileName = "LaborPartyCandidates.txt";
-        else if(party.getName() == "Liberal Party") fileName = "LiberalPartyCandidates.txt";
-        else if(party.getName() == "Foam Party") fileName = "FoamPartyCandidates.txt";
+        // generated scenarios have more electorates than the candidate files so the candidates are named by electorate number
+        if(!scenario.generated){
+            // the candidates are loaded from the party name without spaces followed by Candidates.txt
+            // eg. Labor Party loads LaborPartyCandidates.txt
+            fileName.clear();
+            for(char letter : party.getName()){
+                if(letter != ' ') fileName += letter;
+            }
+            fileName += "Candidates.txt";
 
-        candidateFile.open(fileName);
+            candidateFile.open(fileName);
 
-        if(candidateFile.bad() || !candidateFile.is_open()){
-            cerr<<fileName<<" was unable to be opened"<<endl;
-            exit(1);
+            if(candidateFile.bad() || !candidateFile.is_open()){
+                cerr<<fileName<<" was unable to be opened"<<endl;
+                exit(1);
+            }
         }
 
         // loop used to run through each electorate and generate a candidate for each electorate
-        // uses the electorate name in the candidate constructor.
-        // then loads the candidate into the current party.
-        for(Electorate e : electorates){
-            getline(candidateFile, candidateName);
-
-            Candidate newCandidate(e.getName(), candidateName, party.stanceRanges, issues);
-            party.loadCandidate(newCandidate);
+        // uses the electorate id in the candidate constructor.
+        // then loads the candidate into the candidate table under the electorate and party.
+        for(unsigned int elecIndex = 0; elecIndex < electorates.size(); elecIndex++){
+            if(scenario.generated) candidateName = party.getName() + " Candidate " + to_string(elecIndex + 1);
+            else getline(candidateFile, candidateName);
 
+            addCandidate(elecIndex, party, candidateName);
         }
 
-        candidateFile.close();
+        if(!scenario.generated) candidateFile.close();
     }
 
 
@@ -277,17 +823,18 @@ void Election::generateCandidates(){
 void Election::printElection(){
 
     cout<<"=======================Election Simulator=======================\n"<<endl;
+    cout<<"Seed: "<<seed<<" (run again with --seed "<<seed<<" to repeat this election)\n"<<endl;
 
     cout<<"                         ~~~~ISSUES~~~\n\n"<<endl;
-    cout<<"The 5 issues that Party's and Candidates will be campaigning on and discussing:"<<endl;
+    cout<<"The "<<issues.getNumOfIssues()<<" issues that Party's and Candidates will be campaigning on and discussing:"<<endl;
     cout<<endl;
 
     int count = 1;
 
     // prints out all the individual issues
-    for(Issue i : issues){
+    for(int issue = 0; issue < issues.getNumOfIssues(); issue++){
         cout<<"ISSUE #"<<count<<" - ";
-        i.printIssue();
+        issues.getIssue(issue).printIssue();
         count++;
         cout<<endl;
     }
@@ -296,44 +843,25 @@ void Election::printElection(){
     /* Start of print for Party information */
     cout<<"============================================================================"<<endl;
     cout<<"                           ~~~~PARTIES~~~\n\n"<<endl;
-    cout<<"Party 1: Labor Party"<<endl;
-    cout<<endl;
-    cout<<"The Labor party wants to provide equal opportunities for everyone in the nation, and attempt to make decisions on what's best for the people."<<endl;
-    cout<<endl;
-    cout<<"Leader: "<<parties[0].getLeader().getName()<<endl;
-    cout<<"Leaders Characteristics: ";
-    parties[0].getLeader().printCharacteristics();
-    cout<<endl;
-    cout<<"----------------------------------------------------------------------";
-    cout<<"-------------------------------------------"<<endl;
-    parties[0].printParty();
-    cout<<"-----------------------------------------------------------------------"<<endl;
-
-    cout<<"Party 2: Liberal Party"<<endl;
-    cout<<endl;
-    cout<<"The Liberal party make decisions on what they think is best for the nation, even if this may effect the people of that nation"<<endl;
-    cout<<endl;
-    cout<<"Leader: "<<parties[1].getLeader().getName()<<endl;
-    cout<<"Leaders Characteristics: ";
-    parties[1].getLeader().printCharacteristics();
-    cout<<endl;
-    cout<<"----------------------------------------------------------------------";
-    cout<<"-------------------------------------------"<<endl;
-    parties[1].printParty();
-    cout<<"-----------------------------------------------------------------------"<<endl;
+    for(Party& currentParty : parties){
+        cout<<"Party "<<currentParty.getID() + 1<<": "<<currentParty.getName()<<endl;
+        cout<<endl;
+        if(!currentParty.getDescription().empty()){
+            cout<<currentParty.getDescription()<<endl;
+            cout<<endl;
+        }
+        cout<<"Leader: "<<currentParty.getLeader().getName()<<endl;
+        cout<<"Leaders Characteristics: ";
+        currentParty.getLeader().printCharacteristics();
+        cout<<endl;
+        cout<<"----------------------------------------------------------------------";
+        cout<<"-------------------------------------------"<<endl;
+        currentParty.printParty(candidates, issues);
 
-    cout<<"Party 3: Foam Party"<<endl;
-    cout<<endl;
-    cout<<"The Foam Party just wants everyone to have a good time, they also struggle with making choices on much bigger issues."<<endl;
-    cout<<endl;
-    cout<<"Leader: "<<parties[2].getLeader().getName()<<endl;
-    cout<<"Leaders Characteristics: ";
-    parties[2].getLeader().printCharacteristics();
-    cout<<endl;
-    cout<<"----------------------------------------------------------------------";
-    cout<<"-------------------------------------------"<<endl;
-    parties[2].printParty();
-    cout<<"============================================================================"<<endl;
+        // the last party is followed by the end of the party information
+        if(currentParty.getID() + 1 < (int)parties.size()) cout<<"-----------------------------------------------------------------------"<<endl;
+        else cout<<"============================================================================"<<endl;
+    }
     /* End of print for Party information*/
 
     /* Start of print for Electorate information*/
@@ -343,14 +871,14 @@ void Election::printElection(){
     cout<<endl;
 
     for(Electorate& currentElectorate : electorates){
-        currentElectorate.printElectorate();
+        currentElectorate.printElectorate(voters, issues);
 
         cout<<"----------------------------------------------------------------------"<<endl;
         cout<<"Candidates: "<<endl;
         for(Party& currentParty : parties){
-            auto it = currentParty.getCandidates().find(currentElectorate.getName());
-            cout<<it->second.getName()<<" (";
-            it->second.printCharacteristics();
+            Candidate& candidate = candidates.getCandidate(currentElectorate.getID(), currentParty.getID());
+            cout<<candidate.getName()<<" (";
+            candidate.printCharacteristics();
             cout<<")"<<endl;
 
         }
@@ -369,52 +897,35 @@ void Election::reportElection(){
     cout<<"-----------=======================POST CAMPAIGN REPORT===============================-----------"<<endl;
     /* Start of print for Party information */
     cout<<"                                    ~~~~PARTIES~~~\n"<<endl;
-    cout<<"Party 1: Labor Party"<<endl;
-    cout<<endl;
-    cout<<"Leader: "<<parties[0].getLeader().getName()<<endl;
-    cout<<"Leaders Characteristics: ";
-    parties[0].getLeader().printCharacteristics();
-    cout<<endl;
-    cout<<"----------------------------------------------------------------------";
-    cout<<"-------------------------------------------"<<endl;
-    parties[0].printParty();
-    cout<<"-----------------------------------------------------------------------"<<endl;
-
-    cout<<"Party 2: Liberal Party"<<endl;
-    cout<<endl;
-    cout<<"Leader: "<<parties[1].getLeader().getName()<<endl;
-    cout<<"Leaders Characteristics: ";
-    parties[1].getLeader().printCharacteristics();
-    cout<<endl;
-    cout<<"----------------------------------------------------------------------";
-    cout<<"-------------------------------------------"<<endl;
-    parties[1].printParty();
-    cout<<"-----------------------------------------------------------------------"<<endl;
+    for(Party& currentParty : parties){
+        cout<<"Party "<<currentParty.getID() + 1<<": "<<currentParty.getName()<<endl;
+        cout<<endl;
+        cout<<"Leader: "<<currentParty.getLeader().getName()<<endl;
+        cout<<"Leaders Characteristics: ";
+        currentParty.getLeader().printCharacteristics();
+        cout<<endl;
+        cout<<"----------------------------------------------------------------------";
+        cout<<"-------------------------------------------"<<endl;
+        currentParty.printParty(candidates, issues);
 
-    cout<<"Party 3: Foam Party"<<endl;
-    cout<<endl;
-    cout<<"Leader: "<<parties[2].getLeader().getName()<<endl;
-    cout<<"Leaders Characteristics: ";
-    parties[2].getLeader().printCharacteristics();
-    cout<<endl;
-    cout<<"----------------------------------------------------------------------";
-    cout<<"-------------------------------------------"<<endl;
-    parties[2].printParty();
-    cout<<"============================================================================"<<endl;
+        // the last party is followed by the end of the party information
+        if(currentParty.getID() + 1 < (int)parties.size()) cout<<"-----------------------------------------------------------------------"<<endl;
+        else cout<<"============================================================================"<<endl;
+    }
     /* End of print for Party information */
 
     /* Start of print for Electorate information */
     cout<<"                              ~~~~Electorates~~~\n\n"<<endl;
 
     for(Electorate& currentElectorate : electorates){
-        currentElectorate.printElectorate();
+        currentElectorate.printElectorate(voters, issues);
 
         cout<<"----------------------------------------------------------------------"<<endl;
         cout<<"Candidates: "<<endl;
         for(Party& currentParty : parties){
-            auto it = currentParty.getCandidates().find(currentElectorate.getName());
-            cout<<it->second.getName()<<" (";
-            it->second.printCharacteristics();
+            Candidate& candidate = candidates.getCandidate(currentElectorate.getID(), currentParty.getID());
+            cout<<candidate.getName()<<" (";
+            candidate.printCharacteristics();
             cout<<")"<<endl;
 
         }
@@ -426,484 +937,711 @@ void Election::reportElection(){
 }
 
 
+// function used to run every day of the campaign that is left
+void Election::runCampaign(){
+    runCampaign(numOfDays);
+}
+
 // This function is for running the campaigning simulation
 // It will run from 1-30 days depending on the how many days were entered during execution
 // for each day, each electorate will have a 50% chance to run an event.
 // this is done by generating a random number between 1-2, if it's 2 then an event will be triggered
 // otherwise nothing will happen on that day for that electorate
-void Election::runCampaign(){
+// days is how many of the days left are run, the campaign carries on from the day after the last day that was run
+// so it can be run a few days at a time.
+void Election::runCampaign(int days){
+
+    STATS_PHASE(stats, StatsPhase::CAMPAIGN);
+
+    days = max(0, min(days, numOfDays));
+
+    // the events of each day have to be narrated and journaled in order so they are only run in parallel when they aren't
+    if(campaignThreads > 1 && !journal && !narration.isEnabled(NarrationLevel::DAILY)){
+        runParallelCampaign(days);
+        return;
+    }
+
+    // the polls need every electorate at the end of each day so they are only run electorate major when there aren't any
+    if(campaignOrder == CampaignOrder::ELECTORATE_MAJOR && !journal && !pollOutput && !narration.isEnabled(NarrationLevel::DAILY) && canRunElectorateMajor()){
+        runElectorateMajorCampaign(days);
+        return;
+    }
 
     bool leaderEvent = false; // used to determin if a leader event has happened
-    bool eventFound = false; // used to determine when an event is found.
-    RandomGenerator random; // used for generating random number/shuffling array
     int eventRoll; // used to hold a 1 or 2 to determine if an event goes ahead
     int eventNumber; // used to hold the eventNumber i.e the ID
 
-    cout<<"~~~~~~~~~~~~~~~~~~~~~~~~~~~CAMPAIGNING HAS STARTED~~~~~~~~~~~~~~~~~~~~~~~~~~~"<<endl;
+    narration.narrate(NarrationLevel::DAILY, "~~~~~~~~~~~~~~~~~~~~~~~~~~~CAMPAIGNING HAS STARTED~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+    if(pollOutput && campaignDay == 0) writePollHeader();
+
     // for loop to run from 1 - x amount of days
     // for loop counts down as so we can print the remaining days/loops
-    for(numOfDays; numOfDays>0; --numOfDays){
-        cout<<"\n\n----------===== "<< numOfDays<<" Day(s) until Election =====----------"<<endl;
+    // day counts up from the day after the last day run and is used to select the random streams for the day
+    for(int day = campaignDay + 1; days>0; --days, --numOfDays, day++){
+        campaignDay = day;
+        narration.narrate(NarrationLevel::DAILY, "\n\n----------===== %d Day(s) until Election =====----------\n", numOfDays);
 
         leaderEvent = false; // sets the leaderEvent to false at the start of each day
 
         // For loop is run each day, to determine if an event occurs in each electorate.
-        for(Electorate &currentElectorate : electorates){
-            cout<<"-------------------------------------------------"<<endl;
-            cout<<"Daily report for "<< currentElectorate.getName()<<": "<<endl;
-            cout<<"================================================="<<endl;
+        for(unsigned int elecIndex = 0; elecIndex < electorates.size(); elecIndex++){
+            Electorate &currentElectorate = electorates[elecIndex];
+
+            narration.narrate(NarrationLevel::DAILY, "-------------------------------------------------\n");
+            narration.narrate(NarrationLevel::DAILY, "Daily report for %s: \n", currentElectorate.getName());
+            narration.narrate(NarrationLevel::DAILY, "=================================================\n");
+
+            // the roll and choice of event come from the electorates event selection stream for the day
+            random.setStream(RandomStream::EVENT_SELECT, day, elecIndex);
 
             // used to generate a random number 1 or 2
             // this provides a 50/50 chance of either
             eventRoll = random.randomIntRange(1,2);
 
-            // if eventRoll == 2 then an event is ran
-            if(eventRoll == 2){
-                random.shuffleArray(); // shuffles the array which is used to get random candidates/leaders
-                eventFound = false;
-
-                // This do while loop gets an event number then
-                // the logic in the do while loop first checks to see if it's leader related.
-                // If it's a leader related event it will then check to see if a leader event
-                // has already been ran for this election day.
-                // If a leader event has already been run, then it continues to loop until it's not a leader event.
-                do{
-                    random.shuffleArray();
-                    eventNumber = getEvent();
-                    if(eventNumber == 3 || eventNumber == 4){
-                        if(!leaderEvent){
-                            leaderEvent = true;
-                            eventFound = true;
-                        } else continue;
-                    }
-                    else{
-                        eventFound = true;
-                    }
-                } while(!eventFound);
-
-                //Handle event will run once an event has been found in the above loop
+            // if eventRoll == 2 then an event is picked
+            // only one leader event can happen each day so once one has happened
+            // the event is picked from the events which aren't leader related.
+            // eventNumber is -1 if there are no events left that can happen today
+            eventNumber = eventRoll == 2 ? getEvent(leaderEvent) : -1;
+
+            if(eventNumber != -1){
+                if(events[eventNumber].type == EventType::LEADER_RELATED) leaderEvent = true;
+
+                //Handle event will run once an event has been picked
+                // using the electorates event stream for the day
+                random.setStream(RandomStream::EVENT, day, elecIndex);
+                startRecord(day, elecIndex, eventNumber);
                 handleEvent(eventNumber, &currentElectorate);
+                finishRecord();
 
-                cout<<endl;
+                narration.narrate(NarrationLevel::DAILY, "\n");
 
             }
             else{
-                cout<<"Nothing happened in "<<currentElectorate.getName()<<" today"<<endl;
+                narration.narrate(NarrationLevel::DAILY, "Nothing happened in %s today\n", currentElectorate.getName());
             }
         }
+
+        // the poll only counts the clusters and candidates that changed today
+        if(pollOutput) writePoll(day);
     }
-    cout<<"~~~~~~~~~~~~~~~~~~~~~~~~~~~CAMPAIGNING HAS FINISHED~~~~~~~~~~~~~~~~~~~~~~~~~~~"<<endl;
-    cout<<endl;
+    narration.narrate(NarrationLevel::DAILY, "~~~~~~~~~~~~~~~~~~~~~~~~~~~CAMPAIGNING HAS FINISHED~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+    narration.narrate(NarrationLevel::DAILY, "\n");
 
 }
 
-// function used to obtain random event by first randomising a number between 1-10.
-// depending on the number it then returns the event code to a specific event
-// the event code will then be used to grab the event from the event vector.
-// the variables here can be changed to alter the probability
-int Election::getEvent(){
-    RandomGenerator random;
+// function used to run the campaign with the electorates of each day split between campaignThreads threads
+// gives the same result as the serial campaign as every electorate rolls from its own streams for the day:
+// - every electorate picks its event as if no leader event has happened today, then the electorates after the
+//   first leader event pick again from the events that aren't leader events, like the serial campaign does.
+// - events that only change their own electorate are run by the workers, the shared events that change leaders
+//   or every electorate are run in order on this thread once the electorates before them have finished,
+//   so every electorate sees the same leaders and stances it would have in the serial campaign.
+// - the clusters and candidates changed by the workers are marked for the projection in electorate order
+//   after each segment so the polls are the same as well.
+// the workers, their threads and the event tables are set up once for each call, the days themselves never allocate.
+void Election::runParallelCampaign(int days){
+
+    int numOfElectorates = electorates.size();
+
+    if(pollOutput && campaignDay == 0) writePollHeader();
+
+    sharedEvents.resize(events.getNumOfEvents());
+    for(int event = 0; event < events.getNumOfEvents(); event++){
+        sharedEvents[event] = isSharedEvent(events[event]);
+    }
 
-    int rollEvent = random.randomIntRange(1, 20);
+    for(CampaignWorker& worker : campaignWorkers) campaignDraws += worker.random.getNumOfDraws();
+    campaignWorkers.clear();
+    for(int worker = 0; worker < campaignThreads; worker++){
+        campaignWorkers.push_back(CampaignWorker(seed, runNumber));
+    }
+    dayEvents.assign(numOfElectorates, -1);
+    dayChanges.assign(numOfElectorates, 0);
 
-    if(rollEvent <= 9) return 0; // Candidate Debate sitting at 40% chance
-    else if(rollEvent <= 10) return 1; // Candidate related, Scandal 5% chance
-    else if(rollEvent <= 12) return 2; // Candidate related, prank 10% chance
-    else if(rollEvent <= 13) return 3; // Leader related, boxing 5% chance
-    else if(rollEvent <= 14) return 4; // Leader related, debating 5% chance
-    else if(rollEvent <= 16) return 5; // Issue related, international influence 10% chance
-    else if(rollEvent <= 20) return 6; // Issue related, new issue information 20% chance
+    CampaignScheduler scheduler(*this, campaignThreads);
+    campaignScheduler = &scheduler;
 
-    return 0;
-}
+    for(int day = campaignDay + 1; days>0; --days, --numOfDays, day++){
+        campaignDay = day;
 
+        scheduler.runSegment(&Election::pickParallelEvent, 0, numOfElectorates);
 
+        // only the first leader event of the day can happen
+        int leaderElectorate = numOfElectorates;
+        for(int elecIndex = 0; elecIndex < numOfElectorates; elecIndex++){
+            if(dayEvents[elecIndex] != -1 && events[dayEvents[elecIndex]].type == EventType::LEADER_RELATED){
+                leaderElectorate = elecIndex;
+                break;
+            }
+        }
+        scheduler.runSegment(&Election::repickParallelEvent, leaderElectorate + 1, numOfElectorates);
 
-// This function is to first identify the event and print out any statements regarding the event
-// it also collects the correct parameters needed to then pass to the processEvent function which will
-// hold the logic for each event.
-// The way that random candidates and leaders are chosen for events and ensuring that the picks are unique
-// is that there is a static array RandomGenerator::shuffledArray which holds 3 numbers {0,1,2}
-// these numbers are shuffled prior to an event running, then the candidates/leaders are picked by using the
-// first 2 elements from the shuffled array. This shuffle happens in the multiple sections before
-// handleEvent is called.
-void Election::handleEvent(int event, Electorate* elec){
+        // runs the electorates between the shared events on the workers and each shared event on its own
+        voters.setDirtyTracking(false);
+        int segmentStart = 0;
+        for(int elecIndex = 0; elecIndex < numOfElectorates; elecIndex++){
+            if(dayEvents[elecIndex] == -1 || !sharedEvents[dayEvents[elecIndex]]) continue;
 
-    vector<Candidate*> candidatesInElect; // holds pointers to each candidate in the current electorate
-    vector<Candidate*> leaders; // holds pointers to the party leaders
+            scheduler.runSegment(&Election::runParallelEvent, segmentStart, elecIndex);
+            mergeParallelEvents(segmentStart, elecIndex);
 
-    RandomGenerator random; // used for shuffling array and generating random number between range.
+            voters.setDirtyTracking(true);
+            random.setStream(RandomStream::EVENT, day, elecIndex);
+            startRecord(day, elecIndex, dayEvents[elecIndex]);
+            handleEvent(dayEvents[elecIndex], &electorates[elecIndex]);
+            finishRecord();
+            voters.setDirtyTracking(false);
 
-    //for loop which collects the memory addresses of the related candidates for the current electorate
-    //adds them to a vector holding pointers to the candidates.
-    for(Party& currentParty : parties){
-        Candidate& partyCandidate = currentParty.getCandidates().find(elec->getName())->second;
-        candidatesInElect.push_back(&partyCandidate);
-    }
+            segmentStart = elecIndex + 1;
+        }
+        scheduler.runSegment(&Election::runParallelEvent, segmentStart, numOfElectorates);
+        mergeParallelEvents(segmentStart, numOfElectorates);
+        voters.setDirtyTracking(true);
 
-    //for loop which collects the memory addresses of the leaders
-    //adds them to a vector holding pointers to the leaders.
-    for(Party& currentParty : parties){
-        Candidate& partyLeader = currentParty.getLeader();
-        leaders.push_back(&partyLeader);
+        if(pollOutput) writePoll(day);
     }
 
-    random.shuffleArray(); // shuffles static int array
+    campaignScheduler = nullptr;
 
-    //Switch case which determines which event to run based on the event number
-    switch(event){
-        case 0: // Candidate debate event
-        {
-            Candidate *cand1 = candidatesInElect[RandomGenerator::shuffledArray[0]];
-            Candidate *cand2 = candidatesInElect[RandomGenerator::shuffledArray[1]];
-            printf(events[event].getStatement().c_str(), cand1->getName().c_str(), cand2->getName().c_str());
-            processEvent(event, cand1, cand2, elec);
-        break;
+    for(CampaignWorker& worker : campaignWorkers){
+        stats.add(worker.stats);
+    }
+}
+
+// function used to check if an event changes more than the electorate it happens in
+// leader events change the leaders every electorate shares and national influence changes every electorate.
+bool Election::isSharedEvent(Event& event){
+    if(event.type == EventType::LEADER_RELATED || event.participants == EventParticipants::LEADERS) return true;
+    return event.outcomes[0].influence == EventInfluence::NATIONAL || event.outcomes[1].influence == EventInfluence::NATIONAL;
+}
+
+// function run by a campaign worker to roll for and pick the event of an electorate, as if no leader event has happened today
+void Election::pickParallelEvent(int worker, int elecIndex){
+    RandomGenerator& workerRandom = campaignWorkers[worker].random;
+    workerRandom.setStream(RandomStream::EVENT_SELECT, campaignDay, elecIndex);
+    dayEvents[elecIndex] = workerRandom.randomIntRange(1,2) == 2 ? events.pickEvent(workerRandom, false) : -1;
+}
+
+// function run by a campaign worker to pick the event of an electorate after the leader event of the day again,
+// the roll and pick are made from the start of the stream so they are the same rolls the serial campaign makes
+void Election::repickParallelEvent(int worker, int elecIndex){
+    RandomGenerator& workerRandom = campaignWorkers[worker].random;
+    workerRandom.setStream(RandomStream::EVENT_SELECT, campaignDay, elecIndex);
+    dayEvents[elecIndex] = workerRandom.randomIntRange(1,2) == 2 ? events.pickEvent(workerRandom, true) : -1;
+}
+
+// function run by a campaign worker to run the event of an electorate with the workers own generator, record and stats
+// what the event changed is kept in dayChanges for mergeParallelEvents
+void Election::runParallelEvent(int worker, int elecIndex){
+
+    dayChanges[elecIndex] = 0;
+    if(dayEvents[elecIndex] == -1) return;
+
+    CampaignWorker& campaignWorker = campaignWorkers[worker];
+    campaignWorker.random.setStream(RandomStream::EVENT, campaignDay, elecIndex);
+    campaignWorker.record = EventRecord();
+
+    EventContext context = EventContext();
+    context.random = &campaignWorker.random;
+    context.record = &campaignWorker.record;
+    context.stats = &campaignWorker.stats;
+    context.deferDirty = true;
+
+    handleEvent(dayEvents[elecIndex], &electorates[elecIndex], context);
+
+    if(campaignWorker.record.influence != EventInfluence::NONE) dayChanges[elecIndex] |= clustersChanged;
+    if(context.popularityChanged) dayChanges[elecIndex] |= candidatePopularityChanged;
+}
+
+// function used to mark the clusters and candidates changed by the workers between first and last for the projection
+void Election::mergeParallelEvents(int first, int last){
+    for(int elecIndex = first; elecIndex < last; elecIndex++){
+        if(dayChanges[elecIndex] & clustersChanged){
+            Electorate& currentElectorate = electorates[elecIndex];
+            for(int cluster = currentElectorate.getFirstCluster(); cluster < currentElectorate.getFirstCluster() + currentElectorate.getNumOfClusters(); cluster++){
+                voters.markDirty(cluster);
+            }
         }
+        if(dayChanges[elecIndex] & candidatePopularityChanged) markElectorateDirty(elecIndex);
+    }
+}
 
+// function used to draw the rolls of an influence for count clusters, 1 - 3 for each issue of each cluster
+// the rolls are drawn cluster by cluster as influenceElectorate has always used them and written out issue by issue,
+// the rolls of each issue for the clusters are stride apart in changes.
+static void drawInfluenceRolls(RandomGenerator& random, int count, int numOfIssues, int8_t* changes, int stride){
 
-        case 1: // Candidate Related event 1 - Scandal
-        {
-            Candidate *cand1 = candidatesInElect[RandomGenerator::shuffledArray[0]];
-            printf(events[event].getStatement().c_str(), cand1->getName().c_str());
-            processEvent(event, cand1, nullptr, elec);
+    int clustersPerRoll = influenceRolls / numOfIssues;
+    int rolls[influenceRolls];
+
+    for(int first = 0; first < count; first += clustersPerRoll){
+        int clusters = min(clustersPerRoll, count - first);
+        random.randomIntRange(1, 3, rolls, clusters * numOfIssues);
+
+        for(int cluster = 0; cluster < clusters; cluster++){
+            for(int issue = 0; issue < numOfIssues; issue++){
+                changes[issue * stride + first + cluster] = rolls[cluster * numOfIssues + issue];
+            }
+        }
+    }
+}
+
+// function used to influence every electorate with the stances of a leader after a national event
+// each electorate is influenced using its own national stream for the day, so while the parallel campaign is running
+// the electorates are split between its workers and the clusters they change are marked for the projection afterwards.
+void Election::influenceNation(Stance* stances, bool positiveImpact){
+
+    if(!campaignScheduler){
+        influenceElectorates(stances, positiveImpact, random, 0, electorates.size());
+        return;
+    }
+
+    nationalStances = stances;
+    nationalPositive = positiveImpact;
+
+    voters.setDirtyTracking(false);
+    campaignScheduler->runSegment(&Election::runNationalInfluence, 0, electorates.size());
+    voters.setDirtyTracking(true);
+
+    for(int cluster = 0; cluster < voters.getNumOfClusters(); cluster++){
+        voters.markDirty(cluster);
+    }
+}
+
+// function run by a campaign worker to influence a chunk of electorates after a national event
+void Election::runNationalInfluence(int worker, int first, int last){
+    influenceElectorates(nationalStances, nationalPositive, campaignWorkers[worker].random, first, last);
+}
+
+// function used to influence the electorates from first up to last with the stances of a leader
+// the clusters are influenced in blocks that go across electorates, the rolls of each electorate are drawn from its
+// own national stream for the day into the block, carrying on where they left off when an electorate spans two blocks,
+// then the whole block is moved on each issue at once with influenceClusters.
+void Election::influenceElectorates(Stance* stances, bool positiveImpact, RandomGenerator& random, int first, int last){
+
+    int numOfIssues = voters.getNumOfIssues();
+    int clustersPerBlock = influenceBlockRolls / numOfIssues;
+    int8_t changes[influenceBlockRolls];
+    int16_t targets[MAX_ISSUES];
+
+    for(int issue = 0; issue < numOfIssues; issue++){
+        targets[issue] = stances[issue].getApproach();
+    }
+
+    int elecIndex = first;
+    int cluster = electorates[first].getFirstCluster();
+    int lastCluster = electorates[last - 1].getFirstCluster() + electorates[last - 1].getNumOfClusters();
+    random.setStream(RandomStream::NATIONAL, campaignDay, elecIndex);
+
+    while(cluster < lastCluster){
+        int blockStart = cluster;
+        int blockSize = min(clustersPerBlock, lastCluster - blockStart);
+
+        while(cluster < blockStart + blockSize){
+            Electorate& currentElectorate = electorates[elecIndex];
+            int elecEnd = currentElectorate.getFirstCluster() + currentElectorate.getNumOfClusters();
+            if(cluster == elecEnd){
+                elecIndex++;
+                random.setStream(RandomStream::NATIONAL, campaignDay, elecIndex);
+                continue;
+            }
+
+            int count = min(elecEnd, blockStart + blockSize) - cluster;
+            drawInfluenceRolls(random, count, numOfIssues, changes + cluster - blockStart, blockSize);
+            cluster += count;
+        }
+
+        voters.influenceClusters(blockStart, blockSize, changes, blockSize, targets, positiveImpact);
+    }
+}
+
+// function used to check the campaign can be run electorate major
+// the only events that can change more than their own electorate are leader events between leaders,
+// they only depend on the leaders so they can be run ahead of the electorates.
+bool Election::canRunElectorateMajor(){
+    for(int event = 0; event < events.getNumOfEvents(); event++){
+        Event& currentEvent = events[event];
+        if(!isSharedEvent(currentEvent)) continue;
+        if(currentEvent.type != EventType::LEADER_RELATED) return false;
+        if(currentEvent.participants == EventParticipants::CANDIDATE || currentEvent.participants == EventParticipants::CANDIDATES) return false;
+    }
+    return true;
+}
+
+// function used to run the campaign electorate major, every day is run for a block of electorates before the next block
+// gives the same result as the day major campaign:
+// - the leader event of each day is found and run first, in day order, as they only depend on the leaders which only
+//   leader events change. Their influence on the voters is kept in leaderInfluences instead of being applied.
+// - each block then runs every day for its electorates in the same order as the day major campaign, the electorates
+//   after the leader electorate pick their events without leader events and the leader events influence is applied
+//   to each electorate before its event if it comes after the leader electorate and after its event if it comes before.
+// every roll comes from the stream of its day and electorate so the rolls are the same in either order.
+// the leader electorates and influences of the days being run are set up once for each call, the days never allocate.
+void Election::runElectorateMajorCampaign(int days){
+
+    int numOfElectorates = electorates.size();
+    int firstDay = campaignDay + 1;
+    int lastDay = campaignDay + days;
+
+    for(DeferredInfluence& deferred : leaderInfluences) campaignDraws += deferred.random.getNumOfDraws() - deferred.draws;
+    leaderElectorates.assign(lastDay + 1, numOfElectorates);
+    leaderInfluences.assign(lastDay + 1, DeferredInfluence());
+
+    // the first electorate to pick a leader event each day picks it, the leader events are run in day order
+    for(int day = firstDay; day <= lastDay; day++){
+        campaignDay = day;
+        for(int elecIndex = 0; elecIndex < numOfElectorates; elecIndex++){
+            random.setStream(RandomStream::EVENT_SELECT, day, elecIndex);
+            int eventNumber = random.randomIntRange(1,2) == 2 ? getEvent(false) : -1;
+            if(eventNumber == -1 || events[eventNumber].type != EventType::LEADER_RELATED) continue;
+
+            leaderElectorates[day] = elecIndex;
+            leaderInfluences[day].day = day;
+            leaderInfluences[day].electorate = elecIndex;
+
+            EventContext context = EventContext();
+            context.random = &random;
+            context.record = &currentRecord;
+            context.stats = &stats;
+            context.deferred = &leaderInfluences[day];
+
+            random.setStream(RandomStream::EVENT, day, elecIndex);
+            startRecord(day, elecIndex, eventNumber);
+            handleEvent(eventNumber, &electorates[elecIndex], context);
+            finishRecord();
+            break;
+        }
+    }
+
+    // runs every day for each block of electorates
+    int blockStart = 0;
+    while(blockStart < numOfElectorates){
+
+        int blockEnd = blockStart;
+        int blockClusters = 0;
+        while(blockEnd < numOfElectorates && blockClusters < campaignBlockClusters){
+            blockClusters += electorates[blockEnd].getNumOfClusters();
+            blockEnd++;
+        }
+
+        for(int day = firstDay; day <= lastDay; day++){
+            campaignDay = day;
+            int leaderElectorate = leaderElectorates[day];
+            DeferredInfluence& leaderInfluence = leaderInfluences[day];
+
+            for(int elecIndex = blockStart; elecIndex < blockEnd; elecIndex++){
+
+                // the leader event has already been run, only its influence is left
+                if(elecIndex == leaderElectorate){
+                    applyDeferredInfluence(leaderInfluence, elecIndex);
+                    continue;
+                }
+
+                if(elecIndex > leaderElectorate) applyDeferredInfluence(leaderInfluence, elecIndex);
+
+                random.setStream(RandomStream::EVENT_SELECT, day, elecIndex);
+                int eventNumber = random.randomIntRange(1,2) == 2 ? getEvent(elecIndex > leaderElectorate) : -1;
+                if(eventNumber != -1){
+                    random.setStream(RandomStream::EVENT, day, elecIndex);
+                    startRecord(day, elecIndex, eventNumber);
+                    handleEvent(eventNumber, &electorates[elecIndex]);
+                    finishRecord();
+                }
+
+                if(elecIndex < leaderElectorate) applyDeferredInfluence(leaderInfluence, elecIndex);
+            }
         }
+
+        blockStart = blockEnd;
+    }
+
+    campaignDay = lastDay;
+    numOfDays -= days;
+}
+
+// function used to apply the influence of a leader event to an electorate
+// national influence rolls from the electorates own national stream for the day, influence on the electorate of the
+// event carries on rolling from the events generator where the event left it.
+void Election::applyDeferredInfluence(DeferredInfluence& deferred, int elecIndex){
+
+    Electorate& elec = electorates[elecIndex];
+
+    switch(deferred.influence){
+        case EventInfluence::NATIONAL:
+            random.setStream(RandomStream::NATIONAL, deferred.day, elecIndex);
+            elec.influenceElectorate(voters, deferred.stances, deferred.positive, random);
         break;
 
-        case 2: // Candidate Related event 2 - Prank
-        {
-            Candidate *cand = candidatesInElect[RandomGenerator::shuffledArray[0]];
-            printf(events[event].getStatement().c_str(), cand->getName().c_str());
-            processEvent(event, cand, nullptr, elec);
+        case EventInfluence::ELECTORATE:
+            if(elecIndex != deferred.electorate) return;
+            elec.influenceElectorate(voters, deferred.stances, deferred.positive, deferred.random);
         break;
-        }
 
+        case EventInfluence::STANCE:
+            if(elecIndex != deferred.electorate) return;
+            elec.influenceStance(voters, deferred.stance, deferred.positive, deferred.random);
+        break;
 
-        case 3: // Leader Related event 1 - Boxing match
-        {
-            Candidate *lead1 = leaders[RandomGenerator::shuffledArray[0]];
-            Candidate *lead2 = leaders[RandomGenerator::shuffledArray[1]];
-            printf(events[event].getStatement().c_str(), lead1->getName().c_str(), lead2->getName().c_str(), elec->getName().c_str());
-            processEvent(event, lead1, lead2, elec);
+        case EventInfluence::NONE:
+        default:
+        return;
+    }
+
+    STATS_ADD(stats.influenceCalls, 1);
+    STATS_ADD(stats.clustersTouched, elec.getNumOfClusters());
+}
+
+// function used to obtain a random event from the event catalog
+// the weights in the event file can be changed to alter the probability
+// leaderEventUsed is true once a leader event has happened today so only other events can be picked.
+// returns -1 if no event can be picked
+int Election::getEvent(bool leaderEventUsed){
+    return events.pickEvent(random, leaderEventUsed);
+}
+
+
+
+// function used to run an event in an electorate using the elections own generator, record and stats
+void Election::handleEvent(int event, Electorate* elec){
+
+    EventContext context = EventContext();
+    context.random = &random;
+    context.record = &currentRecord;
+    context.stats = &stats;
+
+    handleEvent(event, elec, context);
+}
+
+// This function is to pick who and what the event is happening to and print the statement of the event
+// it then passes them to the processEvent function which rolls for the outcome of the event.
+// Events between 2 candidates/leaders pick 2 different parties with random.randomPair
+// so the cost of picking them is the same no matter how many parties there are.
+// context holds the generator, record and stats the event is run with.
+void Election::handleEvent(int event, Electorate* elec, EventContext& context){
+
+    Event& currentEvent = events[event];
+    RandomGenerator& random = *context.random;
+    context.elec = elec;
+
+    STATS_ADD(context.stats->eventsByType[static_cast<int>(currentEvent.type)], 1);
+
+    // the candidates of the current electorate are next to each other in the candidate table, one for each party
+    Candidate* candidatesInElect = candidates.getElectorateCandidates(elec->getID());
+    int numOfParties = parties.size();
+    int firstParty, secondParty;
+
+    // picks the participants of the event
+    switch(currentEvent.participants){
+        case EventParticipants::CANDIDATES:
+            random.randomPair(numOfParties, firstParty, secondParty);
+            context.first = &candidatesInElect[firstParty];
+            context.second = &candidatesInElect[secondParty];
         break;
-        }
 
-        case 4: // Leader Related event 2 - Debate
-        {
-            Candidate *lead1 = leaders[RandomGenerator::shuffledArray[0]];
-            Candidate *lead2 = leaders[RandomGenerator::shuffledArray[1]];
-            printf(events[event].getStatement().c_str(), lead1->getName().c_str(), lead2->getName().c_str(), elec->getName().c_str());
-            processEvent(event, lead1, lead2, elec);
+        case EventParticipants::CANDIDATE:
+            context.first = &candidatesInElect[random.randomIntRange(0, numOfParties - 1)];
         break;
-        }
 
-        case 5: // Issue Related event 1 - international influence
-        {
-            IssueType eventIssueType = static_cast<IssueType>(random.randomIntRange(0, 4));
-            events[event].setRelatedIssue(eventIssueType);
-            int issueType = static_cast<underlying_type<IssueType>::type>(eventIssueType);
-            printf(events[event].getStatement().c_str(), elec->getName().c_str(), issues[issueType].getIssueCode().c_str());
-            processEvent(event, nullptr, nullptr, elec);
+        case EventParticipants::LEADERS:
+            random.randomPair(numOfParties, firstParty, secondParty);
+            context.first = &parties[firstParty].getLeader();
+            context.second = &parties[secondParty].getLeader();
         break;
-        }
 
-        case 6: // Issue Related event 1 - information released by candidate
-        {
-            Candidate *cand = candidatesInElect[RandomGenerator::shuffledArray[0]]; // pointer to random candidate in electorate
-            IssueType eventIssueType = static_cast<IssueType>(random.randomIntRange(0, 4)); // gets random issue type
-            events[event].setRelatedIssue(eventIssueType); // sets the current events issue type to the random one collected
-            int issueType = static_cast<underlying_type<IssueType>::type>(eventIssueType); // collects the number of the issueType to identify in the issues vector
-
-            // prints the event statement and fills in the statement with candidate name and related issue
-            printf(events[event].getStatement().c_str(), issues[issueType].getIssueCode().c_str(), cand->getName().c_str());
-            processEvent(event, cand, nullptr, elec); // sends info to process event, nullptr as there is no 2nd candidate.
+        case EventParticipants::NONE:
         break;
-        }
+    }
+
+    // gets random issue for the event
+    if(currentEvent.randomIssue) context.issue = random.randomIntRange(0, issues.getNumOfIssues() - 1);
+
+    narrateEventLine(currentEvent.statement, context);
+    processEvent(currentEvent, context);
+}
 
+// function used to roll for a participant of an event
+// the mean is the sum of the roll terms of the event which is rolled using the events deviation
+int Election::rollForEvent(Event& currentEvent, Candidate* person, EventContext& context){
 
+    int mean = 0;
+    int mngTeamEventHandle = person->getRelatedParty()->getManagerialTeam().getCharValue(Characteristic::EVENTHANDLE);
 
+    for(int x = 0; x < currentEvent.numOfMeanTerms; x++){
+        RollTerm& term = currentEvent.meanTerms[x];
+        if(term.handle) mean += mngTeamEventHandle;
+        else mean += person->getCharValue(term.characteristic) / term.divisor;
     }
+
+    int roll = context.random->standardDeviation(mean, currentEvent.deviation);
+    if(currentEvent.handleBonus) roll += mngTeamEventHandle;
+
+    return roll;
 }
 
-// Function used for processing events, in cases where only one person is affected or no electorate is impacted
-// a null ptr will be sent as person2 and electorate argument
-void Election::processEvent(int event, Candidate* person1, Candidate* person2, Electorate* elec){
+// Function used for processing events, rolls for the participants of the event
+// then runs the success outcome if a contest was won or a check passed, otherwise the failure outcome.
+void Election::processEvent(Event& currentEvent, EventContext& context){
 
-    RandomGenerator random;
-    Event currentEvent = events[event];
-    Candidate* winner;
-    Candidate* loser;
+    bool success;
+    EventRecord& currentRecord = *context.record;
 
-    switch(event){
-        // case for debate event
-        // gets the charisma of both candidates and divides it by 2
-        // rolls for both candidates based on the impacted char + half their charisma
-        // uses a standard deviation of 3 to and then returns the roll and compares them
-        // winner then has their debating and popularity characteristic updated.
-        // The electorate is then influenced based on the winners stances.
-        case 0:
+    currentRecord.participants[0] = context.first ? context.first->getRelatedParty()->getID() : -1;
+    currentRecord.participants[1] = context.second ? context.second->getRelatedParty()->getID() : -1;
+    currentRecord.issue = context.issue;
+
+    switch(currentEvent.roll){
+        // both participants roll and the highest roll wins, a draw is a failure
+        case EventRoll::CONTEST:
         {
-            // variables to hold info used to calculate event outcome
-            int cand1Roll, cand2Roll;
-            int cand1Charisma, cand2Charisma;
-            bool positiveImpact = true;
-            cand1Charisma = person1->getCharValue(Characteristic::CHARISMA)/2; // get charisma values
-            cand2Charisma = person2->getCharValue(Characteristic::CHARISMA)/2;
-
-            cand1Roll = random.standardDeviation(person1->getCharValue(currentEvent.getImpactedChar()) + cand1Charisma, 3); // gets std deviation roll
-            cand2Roll = random.standardDeviation(person2->getCharValue(currentEvent.getImpactedChar()) + cand2Charisma, 3);
-            //cout<<"person 1 roll: "<<cand1Roll<<" Person 2 roll: "<<cand2Roll<<endl;
-            if(cand1Roll > cand2Roll){
-                cout<<person1->getName()<<" has won the debate for "<<person1->getRelatedParty()->getName()<<"!"<<endl;
-                winner = person1;
-            }
-            else if(cand2Roll > cand1Roll){
-                cout<<person2->getName()<<" has won the debate for "<<person2->getRelatedParty()->getName()<<"!"<<endl;
-                winner = person2;
+            int firstRoll = rollForEvent(currentEvent, context.first, context);
+            int secondRoll = rollForEvent(currentEvent, context.second, context);
+            currentRecord.rolls[0] = firstRoll;
+            currentRecord.rolls[1] = secondRoll;
+
+            if(firstRoll > secondRoll){
+                context.winner = context.first;
+                context.loser = context.second;
             }
-            else{
-                cout<<"There was no clear winner of the debate!"<<endl;
-                break;
+            else if(secondRoll > firstRoll){
+                context.winner = context.second;
+                context.loser = context.first;
             }
-
-            // updates winners characteristic which using the impact range of the event
-            // it then influences the electorate which updates their stance approach to be more like the candidates
-            winner->updateChar(currentEvent.getImpactedChar(), currentEvent.getImpactRange());
-            winner->updateChar(Characteristic::POPULARITY, currentEvent.getImpactRange());
-            elec->influenceElectorate(winner->getStances(), positiveImpact);
-            cout<<"The electorates stances on current issues has been influenced by the points made by "<<winner->getName();
-            cout<<" during the debate and has increased their popularity"<<endl;
+            success = context.winner != nullptr;
         break;
         }
 
-        // case for Candidate 1 - Scandal event
-        // gets the charisma of targeted candidate and divides it by 2
-        // rolls for the candidate based on the impacted char + half their charisma
-        // uses a standard deviation of 5 and then returns the roll
-        // and compares it to the eventPassRoll
-        case 1:
+        // the first participant rolls against the pass roll
+        case EventRoll::CHECK:
         {
-            // variables to hold info used to calculate event outcome
-            int candRoll, candCharisma, mngTeamEventHandle;
-            int const eventPassRoll = 30; // this can be changed to impact the pass chance value
-
-            mngTeamEventHandle = person1->getRelatedParty()->getManagerialTeam().getCharValue(Characteristic::EVENTHANDLE); // gets mng team eventhandle
-            candCharisma = person1->getCharValue(Characteristic::CHARISMA)/2; // gets charisma for candidate
-            candRoll = random.standardDeviation(person1->getCharValue(currentEvent.getImpactedChar()) + candCharisma, 5) + mngTeamEventHandle;
-
-            // if event is successful, their popularity is still impacted however
-            // only by half and they get a boost in charisma.
-            if(candRoll >= eventPassRoll){
-                cout<<person1->getName()<<" was somehow able to talk themselves out of the scandal!"<<endl;
-                person1->updateChar(currentEvent.getImpactedChar(), ((currentEvent.getImpactRange() - mngTeamEventHandle) * -1));
-                person1->updateChar(Characteristic::CHARISMA, currentEvent.getImpactRange());
-            }
-            // if event is unsuccessful candidate gets an impact to their popularity
-            else{
-                cout<<person1->getName()<<" has not been able to explain themselves"<<endl;
-                cout<<elec->getName()<<" are not happy with how "<<person1->getName()<<" has handled this situation"<<endl;
-                person1->updateChar(currentEvent.getImpactedChar(), (currentEvent.getImpactRange() * -1));
-            }
+            int firstRoll = rollForEvent(currentEvent, context.first, context);
+            currentRecord.rolls[0] = firstRoll;
+            success = firstRoll >= currentEvent.passRoll;
         break;
         }
 
-
-        // case for Candidate 2 - Prank event
-        // gets the charisma of targeted candidate and divides it by 2
-        // rolls for the candidate based on the impacted char + half their charisma
-        // uses a standard deviation of 5 and then returns the roll
-        // and compares it to the eventPassRoll
-        case 2:
+        // plain roll against the pass roll
+        case EventRoll::CHANCE:
+        default:
         {
-            // variables to hold info used to calculate event outcome
-            int candRoll, candCharisma;
-            int const eventPassRoll = 20;
-
-            candCharisma = person1->getCharValue(Characteristic::CHARISMA)/2; // gets charisma for candidate
-            candRoll = random.standardDeviation(person1->getCharValue(currentEvent.getImpactedChar()) + candCharisma, 5);
-
-            // if event is successful then candidate gets boost to their charisma and impacted char (popularity)
-            if(candRoll >= eventPassRoll){
-                cout<<elec->getName()<<" found the prank that "<<person1->getName()<<" pulled was hilarious!"<<endl;
-                person1->updateChar(currentEvent.getImpactedChar(), currentEvent.getImpactRange());
-                person1->updateChar(Characteristic::CHARISMA, currentEvent.getImpactRange());
-            }
-            // if event is unsuccessful, candidate gets negative impact to popularity
-            else{
-                cout<<elec->getName()<<" was not impressed with the prank that "<<person1->getName()<<" pulled."<<endl;
-                person1->updateChar(currentEvent.getImpactedChar(), (currentEvent.getImpactRange() * -1));
-            }
+            int chanceRoll = context.random->randomIntRange(1, currentEvent.numOfSides);
+            currentRecord.rolls[0] = chanceRoll;
+            success = chanceRoll >= currentEvent.passRoll;
         break;
         }
+    }
 
-        // Leader 1 - boxing event
-        // collects mng team event handling, charisma and popularity and
-        // rolls using ((charisma/2 + eventHandling) + popularity) with std deviation of 3.
-        case 3:
-        {
-            // variables to hold info used to calculate event outcome
-            int lead1Roll, lead2Roll;
-            int lead1Modifier, lead2Modifier;
-            int lead1MngEventHandling, lead2MngEventHandling;
-
-            // gets both candidates mngTeam event handle value
-            // collects charisma with added event handle and rolls using the modifier and popularity
-            lead1MngEventHandling = person1->getRelatedParty()->getManagerialTeam().getCharValue(Characteristic::EVENTHANDLE);
-            lead2MngEventHandling = person2->getRelatedParty()->getManagerialTeam().getCharValue(Characteristic::EVENTHANDLE);
-            lead1Modifier = (person1->getCharValue(Characteristic::CHARISMA)/2) + lead1MngEventHandling;
-            lead2Modifier = (person2->getCharValue(Characteristic::CHARISMA)/2) + lead2MngEventHandling;
-            lead1Roll = random.standardDeviation(person1->getCharValue(currentEvent.getImpactedChar()) + lead1Modifier, 3);
-            lead2Roll = random.standardDeviation(person2->getCharValue(currentEvent.getImpactedChar()) + lead2Modifier, 3);
-
-            // if/else statements determine the winner/loser.
-            // if there is no winner or loser, both leaders get rewarded equally
-            // if there is a winner/loser then the winner is rewarded and loser get rewarded only half
-            // of the impacted stat
-            if(lead1Roll > lead2Roll){
-                winner = person1;
-                loser = person2;
-            }
-            else if(lead2Roll > lead1Roll){
-                winner = person2;
-                loser = person1;
-            }
-            else{
-                cout<<"There was no clear winner of the bout!"<<endl;
-                cout<<"The nation is impressed with both leaders!"<<endl;
-                break;
-            }
+    // the first participant is the winner when they pass a check
+    if(success && currentEvent.roll != EventRoll::CONTEST) context.winner = context.first;
+    if(context.winner) currentRecord.winner = context.winner->getRelatedParty()->getID();
 
-            cout<<winner->getName()<<" has won the bout!"<<endl;
+    applyOutcome(currentEvent, currentEvent.outcomes[success ? 0 : 1], context);
+}
 
-            // updates winners/losers characteristic  using the impact range of the event
-            // the loser gets the impactRange divided by 2.
-            winner->updateChar(currentEvent.getImpactedChar(), currentEvent.getImpactRange());
-            loser->updateChar(currentEvent.getImpactedChar(), (currentEvent.getImpactRange()/2));
-            cout<<"The nation is impressed with how "<<winner->getName();
-            cout<<" handled the fight."<<endl;
-        break;
-        }
+// function used to run an outcome of an event
+// narrates the lines of the outcome, updates the characteristics of the participants
+// then influences the electorate (or every electorate) using the stances of the source of the outcome.
+void Election::applyOutcome(Event& currentEvent, EventOutcome& outcome, EventContext& context){
 
-        // Leader 2 - Debate event
-        // collects mng team event handling, charisma and popularity and
-        // rolls using ((charisma/2 + eventHandling) + popularity) with std deviation of 3
-        // The winner influences EVERY electorate based on their stances
-        case 4:
-        {
-            // variables to hold info used to calculate event outcome
-            int lead1Roll, lead2Roll;
-            int lead1Modifier, lead2Modifier;
-            int lead1MngEventHandling, lead2MngEventHandling;
-            bool positiveImpact = true;
-
-            // gets both candidates mngTeam event handle value
-            // collects charisma with added event handle and rolls using the modifier and popularity
-            // with std deviation of 3
-            lead1MngEventHandling = person1->getRelatedParty()->getManagerialTeam().getCharValue(Characteristic::EVENTHANDLE);
-            lead2MngEventHandling = person2->getRelatedParty()->getManagerialTeam().getCharValue(Characteristic::EVENTHANDLE);
-            lead1Modifier = (person1->getCharValue(Characteristic::CHARISMA)/2) + lead1MngEventHandling;
-            lead2Modifier = (person2->getCharValue(Characteristic::CHARISMA)/2) + lead2MngEventHandling;
-            lead1Roll = random.standardDeviation(person1->getCharValue(currentEvent.getImpactedChar()) + lead1Modifier, 3);
-            lead2Roll = random.standardDeviation(person2->getCharValue(currentEvent.getImpactedChar()) + lead2Modifier, 3);
-
-            // checks if lead1 is the winner
-            if(lead1Roll > lead2Roll){
-                winner = person1;
-            }
-            // checks if lead2 is the winner
-            else if(lead2Roll > lead1Roll){
-                winner = person2;
-            }
-            // else if there is a draw
-            else{
-                cout<<"There was no clear winner of the debate!"<<endl;
-                break;
-            }
+    RandomGenerator& random = *context.random;
+    ElectionStats& stats = *context.stats;
+    DeferredInfluence* deferred = context.deferred;
 
-            cout<<winner->getName()<<" has won the debate for "<<winner->getRelatedParty()->getName()<<"!"<<endl;
+    for(int x = 0; x < outcome.numOfLines; x++){
+        narrateEventLine(outcome.lines[x], context);
+    }
 
-            // updates winners characteristic which using the impact range of the event
-            // it then influences the electorate which updates their stance approach to be more like the candidates
-            winner->updateChar(currentEvent.getImpactedChar(), currentEvent.getImpactRange());
-            winner->updateChar(Characteristic::POPULARITY, currentEvent.getImpactRange());
+    for(int x = 0; x < outcome.numOfChanges; x++){
+        EventChange& change = outcome.changes[x];
+        Candidate* person = getEventTarget(context, change.target);
+        int value = (change.rangeSign * currentEvent.impactRange) / change.rangeDivisor;
+        if(change.handleSign) value += change.handleSign * person->getRelatedParty()->getManagerialTeam().getCharValue(Characteristic::EVENTHANDLE);
+        updateCandidateChar(person, change.characteristic, value, context);
+    }
 
-            // for loop to influence every electorate
-            for(Electorate& currentElectorate : electorates){
-                currentElectorate.influenceElectorate(winner->getStances(), positiveImpact);
-            }
+    context.record->influence = outcome.influence;
 
-            cout<<"The nations stances on current issues has been influenced by the points made by "<<winner->getName();
-            cout<<" during the debate and has increased their popularity"<<endl;
-        break;
+    // the influence is kept to be applied to each electorate later, with the generator where the influence starts rolling
+    if(deferred && outcome.influence != EventInfluence::NONE){
+        deferred->influence = outcome.influence;
+        deferred->positive = outcome.positive;
+        if(outcome.influence == EventInfluence::STANCE && outcome.source == EventTarget::RANDOM){
+            deferred->stance = Stance(context.issue, random.randomIntRange(1,9), random.randomIntRange(1,100));
         }
+        else if(outcome.influence == EventInfluence::STANCE) deferred->stance = getEventTarget(context, outcome.source)->getStances()[context.issue];
+        else deferred->stances = getEventTarget(context, outcome.source)->getStances();
+        deferred->random = random;
+        deferred->draws = random.getNumOfDraws();
+        return;
+    }
 
-        // Issue 1 - International influence
-        // rolls 50/50 to determine if the electorate
-        // is going to be impacted by international influence
-        // creates stance using random range for the issue
-        // for the international influence
-        case 5:
-        {
-            int checkImpact = random.randomIntRange(1,2);
+    switch(outcome.influence){
+        case EventInfluence::ELECTORATE:
+            context.elec->influenceElectorate(voters, getEventTarget(context, outcome.source)->getStances(), outcome.positive, random);
+            STATS_ADD(stats.influenceCalls, 1);
+            STATS_ADD(stats.clustersTouched, context.elec->getNumOfClusters());
+        break;
 
-            // used to get the int of the issue to identify the issue to generate a random influence range
-            int issueType = static_cast<underlying_type<IssueType>::type>(events[event].getIssueType());
+        case EventInfluence::NATIONAL:
+            influenceNation(getEventTarget(context, outcome.source)->getStances(), outcome.positive);
+            STATS_ADD(stats.influenceCalls, electorates.size());
+            STATS_ADD(stats.clustersTouched, voters.getNumOfClusters());
+        break;
 
-            // if checkImpact is 2 it will influence the electorate
-            if(checkImpact == 2){
-                // creates a stance for the issue with random ranges for the international influence
-                Stance internationalStance(issues.at(issueType), random.randomIntRange(1,9), random.randomIntRange(1,100));
-                cout<<elec->getName()<<" are more in agreence with other countries views, their stances have been impacted by International influence"<<endl;
-                elec->influenceStance(internationalStance, true); // influences electorate using the created stance.
+        // the stance is either the sources stance on the issue of the event or a random stance for the issue
+        case EventInfluence::STANCE:
+            if(outcome.source == EventTarget::RANDOM){
+                Stance randomStance(context.issue, random.randomIntRange(1,9), random.randomIntRange(1,100));
+                context.elec->influenceStance(voters, randomStance, outcome.positive, random);
             }
-            else cout<<"Other countries have similar stances to "<<elec->getName()<<" so they are happy with their views."<<endl;
+            else context.elec->influenceStance(voters, getEventTarget(context, outcome.source)->getStances()[context.issue], outcome.positive, random);
+            STATS_ADD(stats.influenceCalls, 1);
+            STATS_ADD(stats.clustersTouched, context.elec->getNumOfClusters());
         break;
-        }
 
-        // Issue 2 - new information event
-        // rolls against candidate mngTeam event handling, charisma and popularity.
-        // if successful, influences electorate and increases popularity and influences
-        // electorate positively.
-        // else it decreases popularity and influence electorates negatively.
-        case 6:
-        {
-            // variables to hold info used to calculate event outcome
-            int candRoll, candCharisma;
-            int const eventPassRoll = 15; // event pass roll for event
-            bool positiveImpact;
-
-            // used to get the int of the issue to identify the issue to impact influence
-            int issueType = static_cast<underlying_type<IssueType>::type>(events[event].getIssueType());
-
-            candCharisma = person1->getCharValue(Characteristic::CHARISMA)/2;
-            candRoll = random.standardDeviation(person1->getCharValue(currentEvent.getImpactedChar()) + candCharisma, 5);
-
-            // checks if candidates roll is successful against eventPassRoll
-            // This is successful outcome
-            if(candRoll >= eventPassRoll){
-                cout<<person1->getName()<<" was able to confirm the new information was credible. "<<endl;
-                cout<<elec->getName()<<" are happy that "<<person1->getName()<<" was able to confirm this new information"<<endl;
-                cout<<elec->getName()<<" stances are more aligned with "<<person1->getName()<<endl;
-                person1->updateChar(currentEvent.getImpactedChar(), currentEvent.getImpactRange());
-                positiveImpact = true;
-            }
-            // if cand roll is not equal orr higher to pass roll
-            // runs unsuccessful event outcome
-            else{
-                cout<<person1->getName()<<" was unable to confirm the new information was credible. "<<endl;
-                cout<<elec->getName()<<" are not happy that "<<person1->getName()<<" would share this fake information"<<endl;
-                cout<<elec->getName()<<" stances are less aligned with "<<person1->getName()<<endl;
-                person1->updateChar(currentEvent.getImpactedChar(), (currentEvent.getImpactRange() * -1));
-                positiveImpact = false;
-            }
+        case EventInfluence::NONE:
+        break;
+    }
+}
+
+// function used to get the participant of an event an outcome applies to
+Candidate* Election::getEventTarget(EventContext& context, EventTarget target){
+    switch(target){
+        case EventTarget::FIRST: return context.first;
+        case EventTarget::SECOND: return context.second;
+        case EventTarget::WINNER: return context.winner;
+        case EventTarget::LOSER: return context.loser;
+        default: return nullptr;
+    }
+}
 
-            // influences electorate
-            elec->influenceStance(person1->getStances().at(issueType), positiveImpact);
+// function used to narrate a line of an event, the values of the line are filled in from the context
+void Election::narrateEventLine(EventLine& line, EventContext& context){
 
-        break;
+    if(!narration.isEnabled(NarrationLevel::DAILY)) return;
+
+    const char* args[MAX_EVENT_TEXT_ARGS];
+
+    for(int x = 0; x < line.numOfArgs; x++){
+        switch(line.args[x]){
+            case EventText::FIRST: args[x] = context.first->getName().c_str(); break;
+            case EventText::SECOND: args[x] = context.second->getName().c_str(); break;
+            case EventText::WINNER: args[x] = context.winner->getName().c_str(); break;
+            case EventText::LOSER: args[x] = context.loser->getName().c_str(); break;
+            case EventText::PARTY: args[x] = context.winner->getRelatedParty()->getName().c_str(); break;
+            case EventText::ELECTORATE: args[x] = context.elec->getName().c_str(); break;
+            case EventText::ISSUE: args[x] = issues.getIssue(context.issue).getIssueCode().c_str(); break;
         }
+    }
 
+    const char* format = events.getText(line.text);
 
+    switch(line.numOfArgs){
+        case 0: narration.narrate(NarrationLevel::DAILY, format); break;
+        case 1: narration.narrate(NarrationLevel::DAILY, format, args[0]); break;
+        case 2: narration.narrate(NarrationLevel::DAILY, format, args[0], args[1]); break;
+        case 3: narration.narrate(NarrationLevel::DAILY, format, args[0], args[1], args[2]); break;
+        default: narration.narrate(NarrationLevel::DAILY, format, args[0], args[1], args[2], args[3]); break;
     }
 }
 
@@ -914,139 +1652,354 @@ void Election::processEvent(int event, Candidate* person1, Candidate* person2, E
 // prints out all voting information for each cluster/candidate
 void Election::tallyVotes(){
 
-    cout<<"~~~~~~~~~~~~~~~~~~~~~================VOTING HAS STARTED================~~~~~~~~~~~~~~~~~~~~~\n"<<endl;
-    // for loop runs through each electorate
-    for(Electorate& currentElectorate : electorates){
+    STATS_PHASE(stats, StatsPhase::TALLY);
+
+    // how to tally the votes.
+    // collect each candidate for an electorate
+    // iterate through each individual stance
+    // create formula which compares the candidates stance
+    // with the electorate clusters stance.
+    // compare the ranges for each candidate for that particular stance
+    // one with the lowest range gets 1 point for that stance
+    // candidate with most points for each stance for the cluster
+    // wins the votes for that cluster
+    // candidate with the most votes after all clusters are checked will win
+    // the electorate and add to the electorate won tally of the party
+
+    // the stances won are counted for a block of electorates at a time by countStancesWon
+    // using the packed candidate stances, then each electorate in the block has its votes calculated.
+    // stancesWon holds the stances won by each candidate for each cluster in the block [party][cluster]
+    unsigned int blockStart = 0; // first electorate in the current block
+
+    buildCandidateMatrix();
+
+    narration.narrate(NarrationLevel::DAILY, "~~~~~~~~~~~~~~~~~~~~~================VOTING HAS STARTED================~~~~~~~~~~~~~~~~~~~~~\n\n");
+
+    while(blockStart < electorates.size()){
+
+        // collects electorates into the block until it holds enough clusters
+        unsigned int blockEnd = blockStart;
+        int blockFirstCluster = electorates[blockStart].getFirstCluster();
+        int blockClusters = 0;
+        while(blockEnd < electorates.size() && blockClusters < clustersPerBlock){
+            blockClusters += electorates[blockEnd].getNumOfClusters();
+            blockEnd++;
+        }
 
-        vector<Candidate*> candidatesInElect; // vector of pointers to hold candidates for current elec
+        stancesWon.resize(parties.size() * blockClusters);
+        countStancesWon(voters, candidateMatrix, blockFirstCluster, blockClusters, stancesWon.data());
+
+        // for loop runs through each electorate in the block
+        // the votes for each electorate are rolled from the electorates own tally stream
+        for(unsigned int elecIndex = blockStart; elecIndex < blockEnd; elecIndex++){
+
+            Electorate& currentElectorate = electorates[elecIndex];
+            random.setStream(RandomStream::TALLY, 0, elecIndex);
+
+            // the candidates for the current electorate, one for each party
+            Candidate* candidatesInElect = candidates.getElectorateCandidates(elecIndex);
+            int numOfParties = candidates.getNumOfParties();
+
+            narration.narrate(NarrationLevel::FULL, "%s (Population: %d) Vote Distribution: \n", currentElectorate.getName(), currentElectorate.getPopulation());
+            narration.narrate(NarrationLevel::FULL, "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+            int count = 1; // count to keep track of current cluster
+
+            // for loop to run through each cluster in an electorate
+            int lastCluster = currentElectorate.getFirstCluster() + currentElectorate.getNumOfClusters();
+            for(int cluster = currentElectorate.getFirstCluster(); cluster < lastCluster; cluster++){
+                narration.narrate(NarrationLevel::FULL, "%s Cluster #%d (Population: %d)\n", currentElectorate.getName(), count, voters.getPopulation(cluster));
+
+                // divides by the amount of stances
+                // which will be used to calculate the total votes for the cluster per stance won
+                int64_t stanceVotes = voters.getPopulation(cluster)/voters.getNumOfIssues();
+
+                // runs through each candidate and calculates the votes for the cluster using the stanceVotes
+                // as collected earlier which multiplies the stanceVotes by the amount of stances won by each candidate
+                // with a standard deviation of 3
+                // this provides a better chance that we dont get any exact amount of votes
+                // which means that the total votes may not be equal to the population of the cluster
+                // however, we can write this off as "Donkey Voters".
+                // the roll can go under 0 for a small cluster so it is kept at 0, no one votes against a candidate.
+                for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+                    int candidateStancesWon = stancesWon[partyIndex * blockClusters + (cluster - blockFirstCluster)];
+                    candidatesInElect[partyIndex].calculateClusterVotes(max((int64_t)0, random.standardDeviation64(stanceVotes, 3)), candidateStancesWon);
+                }
 
-        // for loop to collect candidates for the current electorate
-        for(Party& currentParty : parties){
-            Candidate& partyCandidate = currentParty.getCandidates().find(currentElectorate.getName())->second;
-            candidatesInElect.push_back(&partyCandidate);
-        }
-
-
-        // how to tally the votes.
-        // collect each candidate for an electorate
-        // iterate through each individual stance
-        // create formula which compares the candidates stance
-        // with the electorate clusters stance.
-        // compare the ranges for each candidate for that particular stance
-        // one with the lowest range gets 1 point for that stance
-        // candidate with most points for each stance for the cluster
-        // wins the votes for that cluster
-        // candidate with the most votes after all clusters are checked will win
-        // the electorate and add to the electorate won tally of the party
-
-        cout<<currentElectorate.getName()<<" (Population: "<<currentElectorate.getPopulation()<<") Vote Distribution: "<<endl;
-        cout<<"~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~"<<endl;
-        int count = 1; // count to keep track of current cluster
-
-        // for loop to run through each cluster in an electorate
-        for(ElectorateCluster& currentCluster : currentElectorate.getClusters()){
-            cout<<currentElectorate.getName()<<" Cluster #"<<count<<" (Population: "<<currentCluster.getPopulation()<<")"<<endl;
-
-            // calls to calculate cluster votes and provides the cluster and candidates in elec
-            calculateClusterVotes(&candidatesInElect, &currentCluster);
-            cout<<"-----------------------------------------------------------"<<endl;
-            // runs through the candidates to print the total votes for a cluster
-            for(Candidate* candidate : candidatesInElect){
-                cout<<candidate->getName()<<" votes: "<<candidate->getClusterVotes()<<endl;
+                narration.narrate(NarrationLevel::FULL, "-----------------------------------------------------------\n");
+                // runs through the candidates to print the total votes for a cluster
+                for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+                    Candidate* candidate = &candidatesInElect[partyIndex];
+                    narration.narrate(NarrationLevel::FULL, "%s votes: %d\n", candidate->getName(), candidate->getClusterVotes());
+                }
+                narration.narrate(NarrationLevel::FULL, "\n-----------------------------------------------------------\n");
+
+
+                count++;
             }
-            cout<<"\n-----------------------------------------------------------"<<endl;
 
+            narration.narrate(NarrationLevel::DAILY, "%s total vote tally: \n", currentElectorate.getName());
+            narration.narrate(NarrationLevel::DAILY, "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+            // the first candidate is the winner until another has more votes, so there is always a winner
+            // even when no candidate got a vote
+            Candidate* winner = &candidatesInElect[0]; // pointer to hold the winner
+            int64_t winnerVoteCount = winner->getTotalVotes(); // used to keep track of the current winner vote count
+
+            // runs through each candidate
+            for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+                Candidate* candidate = &candidatesInElect[partyIndex];
+                narration.narrate(NarrationLevel::DAILY, "%s total votes: %d\n", candidate->getName(), candidate->getTotalVotes());
+
+                // if a candidates votes is more than the current winner vote count
+                // it assigns their total votes to the winner vote count
+                // then assigns them as the winner
+                if(candidate->getTotalVotes() > winnerVoteCount){
+                    winnerVoteCount = candidate->getTotalVotes();
+                    winner = candidate;
+                }
+            }
 
-            count++;
+            narration.narrate(NarrationLevel::DAILY, "\n%s has won the election in %s for the %s with a total of %d votes!\n\n", winner->getName(), currentElectorate.getName(), winner->getRelatedParty()->getName(), winner->getTotalVotes());
+
+            // increments the electoratesWon by 1 for the party of the winner of the electorate
+            // and records the winning party index for the electorate
+            winner->getRelatedParty()->updateElectoratesWon();
+            electorateWinners.push_back(winner->getRelatedParty() - &parties[0]);
         }
 
-        cout<<currentElectorate.getName()<<" total vote tally: "<<endl;
-        cout<<"~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~"<<endl;
-        int winnerVoteCount = 0; // used to keep track of the current winner vote count
-        Candidate* winner; // pointer to hold the winner
+        blockStart = blockEnd;
+    }
+    narration.narrate(NarrationLevel::DAILY, "~~~~~~~~~~~~~~~~~~~~~================VOTING HAS FINISHED================~~~~~~~~~~~~~~~~~~~~~\n\n");
+
+
+
+}
+
+// function used to allocate everything the vote tally uses once the election has been generated
+// the candidateMatrix, the stancesWon buffer for the largest block of clusters and the electorateWinners.
+void Election::setUpTally(){
+
+    int numOfParties = parties.size();
+    int numOfIssues = issues.getNumOfIssues();
 
-        // runs through each candidate
-        for(Candidate* candidate : candidatesInElect){
-            cout<<candidate->getName()<<" total votes: "<<candidate->getTotalVotes()<<endl;
+    candidateMatrix.numOfParties = numOfParties;
+    candidateMatrix.numOfIssues = numOfIssues;
+    candidateMatrix.approach.resize(electorates.size() * numOfParties * numOfIssues);
+    candidateMatrix.significance.resize(electorates.size() * numOfParties * numOfIssues);
+    candidateMatrix.popularityBonus.resize(electorates.size() * numOfParties);
 
-            // if a candidates votes is more than the current winner vote count
-            // it assigns their total votes to the winner vote count
-            // then assigns them as the winner
-            if(candidate->getTotalVotes() > winnerVoteCount){
-                winnerVoteCount = candidate->getTotalVotes();
-                winner = candidate;
+    // a block stops taking electorates once it reaches clustersPerBlock so it can go over by
+    // at most one electorate's clusters
+    int maxElectorateClusters = 0;
+    for(Electorate& currentElectorate : electorates){
+        maxElectorateClusters = max(maxElectorateClusters, currentElectorate.getNumOfClusters());
+    }
+    int maxBlockClusters = min(voters.getNumOfClusters(), clustersPerBlock - 1 + maxElectorateClusters);
+    stancesWon.reserve(numOfParties * maxBlockClusters);
+
+    electorateWinners.reserve(electorates.size());
+
+    // the projection caches the stances won for every cluster and the votes for every candidate
+    projectedStancesWon.resize(voters.getNumOfClusters() * numOfParties);
+    projectedVotes.resize(electorates.size() * numOfParties);
+    projectedWinners.resize(electorates.size());
+    electorateDirty.assign(electorates.size(), 0);
+    dirtyElectorates.reserve(electorates.size());
+    projection.seats.resize(numOfParties);
+    projection.votes.resize(numOfParties);
+    voters.getDirtyClusters().reserve(voters.getNumOfClusters());
+}
+
+// function used to pack the stances and popularity of every candidate into the candidateMatrix
+// so the vote tally can read them from flat arrays instead of going through each party.
+void Election::buildCandidateMatrix(){
+
+    int numOfParties = parties.size();
+    int numOfIssues = issues.getNumOfIssues();
+
+    for(unsigned int elecIndex = 0; elecIndex < electorates.size(); elecIndex++){
+        for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+
+            Candidate& candidate = candidates.getCandidate(elecIndex, partyIndex);
+            int candidateIndex = elecIndex * numOfParties + partyIndex;
+
+            // the candidates popularity reduces the range of each of their stances by 1/4 of their popularity
+            candidateMatrix.popularityBonus[candidateIndex] = candidate.getCharValue(Characteristic::POPULARITY)/4;
+
+            for(int issue = 0; issue < numOfIssues; issue++){
+                candidateMatrix.approach[candidateIndex * numOfIssues + issue] = candidate.getStances()[issue].getApproach();
+                candidateMatrix.significance[candidateIndex * numOfIssues + issue] = candidate.getStances()[issue].getSignificance();
             }
         }
+    }
+}
+
+// function used to get the projected result of the election as it stands now
+// the first call counts every cluster, after that only the clusters whose stances have changed and the
+// electorates whose candidates popularity has changed since the last call are counted again
+// so calling it after every event costs as much as the changes made by the event.
+Projection& Election::currentProjection(){
 
-        cout<<"\n"<<winner->getName()<<" has won the election in "<<currentElectorate.getName()<<" for the "
-        <<winner->getRelatedParty()->getName()<<" with a total of "<<winner->getTotalVotes()<<" votes!\n"<<endl;
+    if(!projectionBuilt){
+        buildProjection();
+        return projection;
+    }
+
+    int numOfParties = parties.size();
+    int numOfIssues = issues.getNumOfIssues();
+    const int32_t* clusterElectorate = voters.getElectorates();
+
+    // a change to 1/4 of a candidates popularity changes their range on every stance
+    // so every cluster of their electorate has to be counted again
+    for(int32_t elecIndex : dirtyElectorates){
+        bool bonusChanged = false;
+
+        for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+            int candidateIndex = elecIndex * numOfParties + partyIndex;
+            int popularityBonus = candidates.getCandidate(elecIndex, partyIndex).getCharValue(Characteristic::POPULARITY)/4;
+            if(popularityBonus != candidateMatrix.popularityBonus[candidateIndex]){
+                candidateMatrix.popularityBonus[candidateIndex] = popularityBonus;
+                bonusChanged = true;
+            }
+        }
 
-        // increments the electoratesWon by 1 for the party of the winner of the electorate
-        winner->getRelatedParty()->updateElectoratesWon();
+        if(bonusChanged){
+            Electorate& currentElectorate = electorates[elecIndex];
+            for(int cluster = currentElectorate.getFirstCluster(); cluster < currentElectorate.getFirstCluster() + currentElectorate.getNumOfClusters(); cluster++){
+                voters.markDirty(cluster);
+            }
+        }
+        electorateDirty[elecIndex] = 0;
     }
-    cout<<"~~~~~~~~~~~~~~~~~~~~~================VOTING HAS FINISHED================~~~~~~~~~~~~~~~~~~~~~\n"<<endl;
+    dirtyElectorates.clear();
+
+    // counts the stances won for the dirty clusters again and moves the votes that changed hands,
+    // the electorate of each cluster is marked so its leader is checked again after.
+    // clusters are marked in the order influence goes through them so runs of clusters next to each other
+    // are counted together by the kernel.
+    vector<int32_t>& dirtyClusters = voters.getDirtyClusters();
+    unsigned int runStart = 0;
+    while(runStart < dirtyClusters.size()){
+
+        int firstCluster = dirtyClusters[runStart];
+        int runClusters = 1;
+        while(runStart + runClusters < dirtyClusters.size() && runClusters < clustersPerBlock && dirtyClusters[runStart + runClusters] == firstCluster + runClusters){
+            runClusters++;
+        }
+
+        stancesWon.resize(numOfParties * runClusters);
+        countStancesWon(voters, candidateMatrix, firstCluster, runClusters, stancesWon.data());
+
+        for(int lane = 0; lane < runClusters; lane++){
+            int cluster = firstCluster + lane;
+            int elecIndex = clusterElectorate[cluster];
+            int64_t stanceVotes = voters.getPopulation(cluster)/numOfIssues;
+
+            for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+                uint8_t& cachedStancesWon = projectedStancesWon[cluster * numOfParties + partyIndex];
+                int change = stancesWon[partyIndex * runClusters + lane] - cachedStancesWon;
+                if(change == 0) continue;
+
+                cachedStancesWon += change;
+                projectedVotes[elecIndex * numOfParties + partyIndex] += change * stanceVotes;
+                projection.votes[partyIndex] += change * stanceVotes;
+            }
 
+            markElectorateDirty(elecIndex);
+        }
+
+        runStart += runClusters;
+    }
+    voters.clearDirty();
 
+    for(int32_t elecIndex : dirtyElectorates){
+        updateProjectedWinner(elecIndex);
+        electorateDirty[elecIndex] = 0;
+    }
+    dirtyElectorates.clear();
 
+    return projection;
 }
 
-// calculate cluster function which determines the votes per candidate per cluster
-// based on which candidate has majority closer stances to the cluster
-// using the formula described below
-void Election::calculateClusterVotes(vector<Candidate*>* candidatesInElec, ElectorateCluster* cluster){
+// function used to count the projection from scratch
+// the stances won are counted for blocks of clusters at a time by countStancesWon and cached for each cluster.
+void Election::buildProjection(){
 
-    Candidate* stanceWinner; // pointer to hold winner
-    RandomGenerator random;
-    int totalClusterPop = cluster->getPopulation(); // gets cluster total pop
+    int numOfParties = parties.size();
+    int numOfIssues = issues.getNumOfIssues();
+    int numOfClusters = voters.getNumOfClusters();
+    const int32_t* clusterElectorate = voters.getElectorates();
 
-    // divides by the amount of stances
-    // which will be used to calculate the total votes for the cluster per stance won
-    int stanceVotes = totalClusterPop/5;
-    int stanceIndex = 0;
+    buildCandidateMatrix();
 
-    // for loop to run through the stances for the cluster and compare them with each candidate
-    for(Stance& currentStance : cluster->getStances()){
-        int previousRange = 999999; // variable to hold the "range" between candidate and electorate cluster stance
+    projection.seats.assign(numOfParties, 0);
+    projection.votes.assign(numOfParties, 0);
+    projection.totalVotes = 0;
+    projectedVotes.assign(projectedVotes.size(), 0);
+    projectedWinners.assign(projectedWinners.size(), -1);
 
-        // for loop to run through each candidate
-        // collects the candidates App/Sig for the currentStance
-        // uses getRange to determine the stance range of the app/Sig of the candidate and electorate cluster
-        // adds both ranges together and then also uses 1/4 of the candidates popularity to reduce the range
-        // if the totalRange is lower than the previous Range
-        // it will assign previousRange to totalRange
-        // and assign the candidate as stanceWinner
-        for(Candidate* candidate : *candidatesInElec){
-            int candStanceApp = candidate->getStances().at(stanceIndex).getApproach();
-            int candStanceSig = candidate->getStances().at(stanceIndex).getSignificance();
+    for(int blockStart = 0; blockStart < numOfClusters; blockStart += clustersPerBlock){
+        int blockClusters = min(clustersPerBlock, numOfClusters - blockStart);
 
-            int appRange = getRange(candStanceApp, currentStance.getApproach());
-            int sigRange = getRange(candStanceSig, currentStance.getSignificance());
+        stancesWon.resize(numOfParties * blockClusters);
+        countStancesWon(voters, candidateMatrix, blockStart, blockClusters, stancesWon.data());
 
-            int totalRange = appRange + sigRange;
-            totalRange -= (candidate->getCharValue(Characteristic::POPULARITY)/4);
+        for(int lane = 0; lane < blockClusters; lane++){
+            int cluster = blockStart + lane;
+            int elecIndex = clusterElectorate[cluster];
+            int64_t stanceVotes = voters.getPopulation(cluster)/numOfIssues;
 
-            if(totalRange < previousRange){
-                previousRange = totalRange;
-                stanceWinner = candidate;
+            for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+                int clusterStancesWon = stancesWon[partyIndex * blockClusters + lane];
+                projectedStancesWon[cluster * numOfParties + partyIndex] = clusterStancesWon;
+                projectedVotes[elecIndex * numOfParties + partyIndex] += clusterStancesWon * stanceVotes;
+                projection.votes[partyIndex] += clusterStancesWon * stanceVotes;
+                projection.totalVotes += clusterStancesWon * stanceVotes;
             }
         }
+    }
 
-        stanceWinner->updateStancesWon(); // increments stancesWon by 1 for stanceWinner
+    for(unsigned int elecIndex = 0; elecIndex < electorates.size(); elecIndex++){
+        updateProjectedWinner(elecIndex);
+    }
 
-        stanceIndex++; // goes to next stance
+    // everything is counted so nothing is dirty anymore
+    voters.clearDirty();
+    for(int32_t elecIndex : dirtyElectorates){
+        electorateDirty[elecIndex] = 0;
     }
+    dirtyElectorates.clear();
+
+    projectionBuilt = true;
+}
 
-    // runs through each candidate and calculates the votes for the cluster using the stanceVotes
-    // as collected earlier which multiplies the stanceVotes by the amount of stances won by each candidate
-    // with a standard deviation of 3
-    // this provides a better chance that we dont get any exact amount of votes
-    // which means that the total votes may not be equal to the population of the cluster
-    // however, we can write this off as "Donkey Voters".
-    for(Candidate* candidate : *candidatesInElec){
-        candidate->calculateClusterVotes(random.standardDeviation(stanceVotes, 3));
+// function used to mark an electorate to be looked at again by currentProjection
+void Election::markElectorateDirty(int elecIndex){
+    if(electorateDirty[elecIndex]) return;
+    electorateDirty[elecIndex] = 1;
+    dirtyElectorates.push_back(elecIndex);
+}
+
+// function used to find the party leading an electorate in the projection and move the seat if it has changed
+// the first party with the most votes leads, unlike tallyVotes no party leads if nobody has any votes.
+void Election::updateProjectedWinner(int elecIndex){
+
+    int numOfParties = parties.size();
+    int winner = -1;
+    int64_t winnerVotes = 0;
+
+    for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+        if(projectedVotes[elecIndex * numOfParties + partyIndex] > winnerVotes){
+            winnerVotes = projectedVotes[elecIndex * numOfParties + partyIndex];
+            winner = partyIndex;
+        }
     }
 
+    int previousWinner = projectedWinners[elecIndex];
+    if(winner == previousWinner) return;
 
+    if(previousWinner != -1) projection.seats[previousWinner]--;
+    if(winner != -1) projection.seats[winner]++;
+    projectedWinners[elecIndex] = winner;
 }
 
 // function uses the popularity of the party leaders which impacts their candidates
@@ -1055,19 +2008,23 @@ void Election::calculateClusterVotes(vector<Candidate*>* candidatesInElec, Elect
 // They will only receive 1/4 of their leaders popularity value.
 void Election::calculatePopularity(){
 
+    STATS_PHASE(stats, StatsPhase::POPULARITY);
+
     for(Party& currentParty : parties){
 
-        map<string, Candidate>::iterator it;
-        map<string, Candidate>& candidates = currentParty.getCandidates();
         int leaderPop = currentParty.getLeader().getCharValue(Characteristic::POPULARITY);
-        for(it = candidates.begin(); it != candidates.end(); it++){
-            int candidatePop = it->second.getCharValue(Characteristic::POPULARITY);
+        for(int elecIndex = 0; elecIndex < candidates.getNumOfElectorates(); elecIndex++){
+            Candidate& candidate = candidates.getCandidate(elecIndex, currentParty.getID());
+            int candidatePop = candidate.getCharValue(Characteristic::POPULARITY);
             if(candidatePop < leaderPop){
                 int popModifier = leaderPop/4;
-                it->second.updateChar(Characteristic::POPULARITY, popModifier);
+                candidate.updateChar(Characteristic::POPULARITY, popModifier);
             }
         }
     }
+
+    // the candidates popularity has changed everywhere so the projection is counted again from scratch
+    projectionBuilt = false;
 }
 
 
@@ -1082,9 +2039,11 @@ void Election::calculatePopularity(){
 // These 2 variables are then compared to see if they are equal (to determine hung parliment)
 void Election::determineWinner(){
 
-    cout<<"The votes are in and the Election is coming to an end.\n"<<endl;
-    cout<<"===================================RESULTS===================================\n"<<endl;
-    Party* winner; // holds pointer to winner Party
+    STATS_PHASE(stats, StatsPhase::WINNER);
+
+    narration.narrate(NarrationLevel::SUMMARY, "The votes are in and the Election is coming to an end.\n\n");
+    narration.narrate(NarrationLevel::SUMMARY, "===================================RESULTS===================================\n\n");
+    Party* winner = &parties[0]; // holds pointer to winner Party
 
     // below variables holds winner and runner up elec counts
     // these 2 variables are used to determine a hung parliment
@@ -1095,13 +2054,14 @@ void Election::determineWinner(){
     // for loop to run through each party and check electorates won
     // and prints out how many electorates won for each party
     for(Party &currentParty : parties){
-        cout<<currentParty.getName()<<" has "<<currentParty.getElectoratesWon()<<" Candidate's who have been elected in their respective electorate."<<endl;
+        narration.narrate(NarrationLevel::SUMMARY, "%s has %d Candidate's who have been elected in their respective electorate.\n", currentParty.getName(), currentParty.getElectoratesWon());
 
         // if currentParty's electorates won is higher than current winnerElec count
         // assigns currentParty as winner and sets their elec count to winner elecCount
         if(currentParty.getElectoratesWon() > currentWinnerElecCount){
             currentWinnerElecCount = currentParty.getElectoratesWon();
             winner = &currentParty;
+            winningParty = winner - &parties[0];
         }
         // if not higher than winner count but higher than runner up, sets their elec count as the runner up count
         else if(currentParty.getElectoratesWon() > runnerUpElecCount){
@@ -1111,613 +2071,3412 @@ void Election::determineWinner(){
 
     // checks for hung parliment
     if(currentWinnerElecCount == runnerUpElecCount) hungParliment = true;
+    hungParliament = hungParliment;
 
     // if a hung parliment, then prints out the result
     if(hungParliment){
-        cout<<"\n\nOh no! No party has enough seats to secure parliament!"<<endl;
-        cout<<"\n\nTHIS HAS RESULTED IN A HUNG PARLIAMENT, NO ONE HAS BEEN ELECTED PRIME MINISTER\n\n"<<endl;
+        narration.narrate(NarrationLevel::SUMMARY, "\n\nOh no! No party has enough seats to secure parliament!\n");
+        narration.narrate(NarrationLevel::SUMMARY, "\n\nTHIS HAS RESULTED IN A HUNG PARLIAMENT, NO ONE HAS BEEN ELECTED PRIME MINISTER\n\n\n");
     }
     // if not hung parliment, prints the winner/prime minister
     else{
-        cout<<endl;
-        cout<<winner->getName()<<" has won the election!\n"<<endl;
-        cout<<winner->getLeader().getName()<<" has been elected as Prime Minister!\n\n"<<endl;
+        narration.narrate(NarrationLevel::SUMMARY, "\n");
+        narration.narrate(NarrationLevel::SUMMARY, "%s has won the election!\n\n", winner->getName());
+        narration.narrate(NarrationLevel::SUMMARY, "%s has been elected as Prime Minister!\n\n\n", winner->getLeader().getName());
     }
 
 
 }
 
+// function used to set the characteristics a person has to the values given, one for each Characteristic
+static void restoreCharacteristics(Person& person, const uint8_t* values){
+    for(int chrIndex = 0; chrIndex < NUM_OF_CHARACTERISTICS; chrIndex++){
+        Characteristic chr = static_cast<Characteristic>(chrIndex);
+        if(person.hasChar(chr)) person.updateChar(chr, values[chrIndex] - (int)person.getCharValue(chr));
+    }
+}
 
+// function used to take a snapshot of everything about the election that changes once it has been generated,
+// it is taken between campaign days (or once the election has finished) so it can be restored or forked from later.
+ElectionSnapshot Election::snapshot(){
 
-/*  Start of Issue functions */
-// constructor for Issue
-Issue::Issue(string iCode, string issueStatement, IssueType typeIssue){
-    statement = issueStatement;
-    type = typeIssue;
-    code = iCode;
-}
+    int numOfParties = parties.size();
+    ElectionSnapshot electionSnapshot;
 
-//copy constructor for Issue
-Issue::Issue(const Issue &issueCopy){
-    type = issueCopy.type;
-    statement = issueCopy.statement;
-    code = issueCopy.code;
-}
+    electionSnapshot.runNumber = runNumber;
+    electionSnapshot.campaignDay = campaignDay;
+    electionSnapshot.daysLeft = numOfDays;
 
-// print function for Issue
-void Issue::printIssue(){
-    cout<<code<<":"<<endl;
-    cout<<statement<<endl;
-}
+    electionSnapshot.approaches.resize(voters.getNumOfIssues() * voters.getNumOfClusters());
+    voters.copyApproaches(electionSnapshot.approaches.data());
 
-// Below are getters/setters needed
-string Issue::getStatement(){
-    return this->statement;
-}
+    electionSnapshot.characteristics.reserve((electorates.size() + 1) * numOfParties * NUM_OF_CHARACTERISTICS);
+    electionSnapshot.votes.reserve(electorates.size() * numOfParties);
+    for(unsigned int elecIndex = 0; elecIndex < electorates.size(); elecIndex++){
+        for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+            Candidate& candidate = candidates.getCandidate(elecIndex, partyIndex);
+            for(int chrIndex = 0; chrIndex < NUM_OF_CHARACTERISTICS; chrIndex++){
+                electionSnapshot.characteristics.push_back(candidate.getCharValue(static_cast<Characteristic>(chrIndex)));
+            }
+            electionSnapshot.votes.push_back(candidate.getTotalVotes());
+        }
+    }
+    for(Party& currentParty : parties){
+        for(int chrIndex = 0; chrIndex < NUM_OF_CHARACTERISTICS; chrIndex++){
+            electionSnapshot.characteristics.push_back(currentParty.getLeader().getCharValue(static_cast<Characteristic>(chrIndex)));
+        }
+        electionSnapshot.electoratesWon.push_back(currentParty.getElectoratesWon());
+    }
 
-IssueType& Issue::getIssueType(){
-    return this->type;
-}
+    electionSnapshot.electorateWinners = electorateWinners;
+    electionSnapshot.winningParty = winningParty;
+    electionSnapshot.hungParliament = hungParliament;
 
-string Issue::getIssueCode(){
-    return this->code;
+    return electionSnapshot;
 }
 
-/*  Start of Electorate functions */
-//Electorate constructor
-Electorate::Electorate(vector<Issue> issues, string eName, int totalPop){
-    name = eName;
-    totalPopulation = totalPop;
+// function used to put the election back to a snapshot taken of it or of the election it was forked from
+// the election carries on from the snapshot with the random streams of the run the snapshot was taken with
+// so it runs the rest of the campaign exactly as it would have the first time.
+void Election::restore(ElectionSnapshot& electionSnapshot){
+    restore(electionSnapshot, electionSnapshot.runNumber);
 }
 
-// function used to add a cluster to clusters vector
-void Electorate::addCluster(ElectorateCluster cluster){
-    clusters.push_back(cluster);
-}
+// function used to put the election back to a snapshot and carry on from it with the random streams of run branch
+// so every branch is a different future from the day the snapshot was taken on.
+// nothing is allocated so the same election can be restored for every branch.
+void Election::restore(ElectionSnapshot& electionSnapshot, uint32_t branch){
 
-// function used to print electorate information
-void Electorate::printElectorate(){
+    int numOfParties = parties.size();
 
-    cout<<name<<" (Population: "<<totalPopulation<<")"<<endl;
-    cout<<"~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~";
-    cout<<"~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~"<<endl;
-    cout<<"Stances (Sig/App)                ";
-    cout<<"COVID-19 Financial";
-    cout<<setw(15)<<"Sauce Debate";
-    cout<<setw(25)<<"Toilet Paper Shortage";
-    cout<<setw(17)<<"Global Warming";
-    cout<<setw(20)<<"Mandatory Vaccines";
-    cout<<endl;
-    cout<<"----------------------------------------------------------------------";
-    cout<<"------------------------------------------------------------------"<<endl;
-    printClusters();
-
-}
+    runNumber = branch;
+    random.setRun(branch);
+    campaignDay = electionSnapshot.campaignDay;
+    numOfDays = electionSnapshot.daysLeft;
 
-// function used to print all clusters for an electorate
-void Electorate::printClusters(){
+    voters.setApproaches(electionSnapshot.approaches.data());
 
-        int count = 1;
-        for(ElectorateCluster& currentCluster : clusters){
-            cout<<"Cluster #"<<count<<" ("<<currentCluster.getPopulation()<<" people)";
-            currentCluster.printStances();
-            count++;
+    const uint8_t* characteristics = electionSnapshot.characteristics.data();
+    for(unsigned int elecIndex = 0; elecIndex < electorates.size(); elecIndex++){
+        for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+            Candidate& candidate = candidates.getCandidate(elecIndex, partyIndex);
+            restoreCharacteristics(candidate, characteristics);
+            candidate.setTotalVotes(electionSnapshot.votes[elecIndex * numOfParties + partyIndex]);
+            characteristics += NUM_OF_CHARACTERISTICS;
         }
-}
-
-// below functions are getters/setters for Electorate
-string Electorate::getName(){
-    return this->name;
-}
-
-int Electorate::getPopulation(){
-    return this->totalPopulation;
-}
+    }
+    for(Party& currentParty : parties){
+        restoreCharacteristics(currentParty.getLeader(), characteristics);
+        currentParty.setElectoratesWon(electionSnapshot.electoratesWon[currentParty.getID()]);
+        characteristics += NUM_OF_CHARACTERISTICS;
+    }
 
-void Electorate::setPopulation(unsigned int pop){
-    this->totalPopulation = pop;
-}
+    electorateWinners = electionSnapshot.electorateWinners;
+    winningParty = electionSnapshot.winningParty;
+    hungParliament = electionSnapshot.hungParliament;
 
-vector<ElectorateCluster>& Electorate::getClusters(){
-    return this->clusters;
+    // the clusters and candidates have all changed so the projection is counted again from scratch
+    projectionBuilt = false;
 }
 
-//function used to influence each stance of an electorate
-void Electorate::influenceElectorate(vector<Stance> candidateStances, bool positiveImpact){
-
-    RandomGenerator random; // randomGenerator used to provide random stance range to update
-                            // between 1-3
-
-    // if statement runs if it is a positive impact
-    // i.e. updates stances to be more aligned with the candidates.
-    // runs through each cluster and each stance and compares the stance with the stances from the candidate
-    // updates it accordingly.
-    if(positiveImpact){
-        for(ElectorateCluster &cluster : clusters){
-            for(Stance &clusterStance : cluster.getStances()){
-                for(Stance &candidateStance : candidateStances){
-                    if(clusterStance.getIssue().getIssueType() == candidateStance.getIssue().getIssueType()){
-                        if(clusterStance.getApproach() > candidateStance.getApproach()){
-                            cluster.updateStance(clusterStance.getIssue(), (random.randomIntRange(1,3) * -1));
-                        }
-                        else cluster.updateStance(clusterStance.getIssue(), random.randomIntRange(1,3));
-
-                    }
-                }
-            }
-        }
-    }
-    // if not a positiveImpact
-    else{
-        for(ElectorateCluster &cluster : clusters){
-            for(Stance &clusterStance : cluster.getStances()){
-                for(Stance &candidateStance : candidateStances){
-                    if(clusterStance.getIssue().getIssueType() == candidateStance.getIssue().getIssueType()){
-                        if(clusterStance.getApproach() > candidateStance.getApproach()){
-                            cluster.updateStance(clusterStance.getIssue(), random.randomIntRange(1,3));
-                        }
-                        else cluster.updateStance(clusterStance.getIssue(), (random.randomIntRange(1,3) * -1));
-
-                    }
-                }
-            }
+// function used to make a new election from where this election is up to, which carries on with the random streams of run branch.
+// the fork shares everything that never changes once the election is generated with this election, the names, issues,
+// stance ranges, cluster populations and significances and the candidates stances, so making it only costs as much as
+// copying the approaches of the clusters and the candidates and setting up the vote tally.
+// forking with the run number of this election gives an election which carries on exactly as this one will.
+// the fork isn't journaled or polled and is narrated at narrationLevel.
+unique_ptr<Election> Election::fork(uint32_t branch, NarrationLevel narrationLevel){
+
+    unique_ptr<Election> forkedElection;
+    forkedElection.reset(new Election(numOfElectorates, numOfDays, seed, branch, narrationLevel));
+    Election& forked = *forkedElection;
+
+    forked.scenario = scenario;
+    forked.issues = issues;
+    forked.events = events;
+    forked.parties = parties;
+    forked.electorates = electorates;
+    forked.candidates = candidates;
+    forked.voters.shareClusters(voters);
+    forked.campaignThreads = campaignThreads;
+    forked.campaignOrder = campaignOrder;
+    forked.campaignDay = campaignDay;
+
+    // the copied leaders and candidates still point at the parties of this election
+    for(Party& party : forked.parties){
+        party.getLeader().setRelatedParty(&party);
+        for(int elecIndex = 0; elecIndex < forked.candidates.getNumOfElectorates(); elecIndex++){
+            forked.candidates.getCandidate(elecIndex, party.getID()).setRelatedParty(&party);
         }
     }
 
+    forked.setUpTally();
+    forked.electorateWinners = electorateWinners;
+    forked.winningParty = winningParty;
+    forked.hungParliament = hungParliament;
+
+    return forkedElection;
 }
 
-// function used to influence/update an individual stance of an electorate
-void Electorate::influenceStance(Stance stance, bool positiveImpact){
-
-    RandomGenerator random; // randomGenerator used to provide random stance range to update
-                            // between 1-3
-
-    // if statement runs if it is a positive impact
-    // i.e. updates stance to be more aligned with the candidates.
-    // runs through each cluster and compares the stance with the stance provided
-    // updates it accordingly.
-    if(positiveImpact){
-        for(ElectorateCluster &cluster : clusters){
-            for(Stance &clusterStance : cluster.getStances()){
-                if(clusterStance.getIssue().getIssueCode() == stance.getIssue().getIssueCode()){
-                    if(clusterStance.getApproach() > stance.getApproach()){
-                        cluster.updateStance(clusterStance.getIssue(), (random.randomIntRange(1,3) * -1));
-                    }
-                    else cluster.updateStance(clusterStance.getIssue(), random.randomIntRange(1,3));
-                }
-            }
-        }
-    }
-    // else runs if it's not a positiveImpact
-    // i.e. updates stance to be less aligned with the candidates.
-    else{
-        for(ElectorateCluster &cluster : clusters){
-            for(Stance &clusterStance : cluster.getStances()){
-                if(clusterStance.getIssue().getIssueCode() == stance.getIssue().getIssueCode()){
-                    if(clusterStance.getApproach() > stance.getApproach()){
-                        cluster.updateStance(clusterStance.getIssue(), random.randomIntRange(1,3));
-                    }
-                    else cluster.updateStance(clusterStance.getIssue(), (random.randomIntRange(1,3) * -1));
-                }
-            }
-        }
-    }
+// below are getters for Election results
+vector<Party>& Election::getParties(){
+    return this->parties;
+}
 
+vector<Electorate>& Election::getElectorates(){
+    return this->electorates;
 }
 
-/*  Start of ElectorateCluster functions */
-//ElectorateCluster constructor
-ElectorateCluster::ElectorateCluster(int pop){
-    population = pop;
+CandidateTable& Election::getCandidates(){
+    return this->candidates;
 }
 
-// used to add a stance to ElectorateClusters stances vector
-void ElectorateCluster::addStance(Stance newStance){
-    stances.push_back(newStance);
+VoterStore& Election::getVoters(){
+    return this->voters;
 }
 
-// used to update the stances of clusters
-void ElectorateCluster::updateStance(Issue issue, int stanceApp){
+CandidateMatrix& Election::getCandidateMatrix(){
+    return this->candidateMatrix;
+}
 
-    for(Stance &currentStance : stances){
-        int newStanceApp = currentStance.getApproach() + stanceApp;
-        if(currentStance.getIssue().getIssueType() == issue.getIssueType()){
-            currentStance.setApproach(newStanceApp);
-        }
-    }
+EventCatalog& Election::getEvents(){
+    return this->events;
+}
 
+vector<int>& Election::getElectorateWinners(){
+    return this->electorateWinners;
 }
 
-// used to print stances of clusters
-void ElectorateCluster::printStances(){
+int Election::getWinningParty(){
+    return this->winningParty;
+}
 
-    cout<<setw(16);
-    for(Stance& stance : stances){
-        if(stance.getIssue().getIssueType() == IssueType::ECONOMIC) cout<<setw(16);
-        else if(stance.getIssue().getIssueType() == IssueType::ENVIRONMENTAL) cout<<setw(20);
-        else cout<<setw(16);
-        cout<<stance.getSignificance()<<"/"<<stance.getApproach();
-    }
-    cout<<endl;
+bool Election::isHungParliament(){
+    return this->hungParliament;
+}
+
+// function used to get the stats of the election, the random draws are taken from the generator when asked for
+ElectionStats& Election::getStats(){
+    stats.randomDraws = random.getNumOfDraws() + campaignDraws;
+    for(CampaignWorker& worker : campaignWorkers) stats.randomDraws += worker.random.getNumOfDraws();
+    for(DeferredInfluence& deferred : leaderInfluences) stats.randomDraws += deferred.random.getNumOfDraws() - deferred.draws;
+    return stats;
 }
 
-// used to get population of cluster
-int ElectorateCluster::getPopulation(){
-    return this->population;
+int Election::getCampaignDay(){
+    return this->campaignDay;
 }
 
-//used to get stances of cluster
-vector<Stance>& ElectorateCluster::getStances(){
-    return this->stances;
+uint64_t Election::getSeed(){
+    return this->seed;
 }
-/*  End of ElectorateCluster functions */
 
+/*  End of Election functions */
 
 
-/*  Start of RandomGenerator functions */
+/*  Start of ElectionSnapshot functions */
+// ElectionSnapshot constructor, the snapshot is empty until it is filled in by Election::snapshot
+ElectionSnapshot::ElectionSnapshot(){
+    runNumber = 0;
+    campaignDay = 0;
+    daysLeft = 0;
+    winningParty = -1;
+    hungParliament = false;
+}
 
-// static engine used by RandomGenerator functions
-default_random_engine RandomGenerator::randomEngine = default_random_engine(time(0));
+/*  End of ElectionSnapshot functions */
 
-//function used to generate random int between range
-int RandomGenerator::randomIntRange(int min, int max){
-    uniform_int_distribution<int> distribution(min,max);
 
-    return distribution(randomEngine);
+/*  Start of ScenarioSpec functions */
+// ScenarioSpec constructor, by default the electorates are loaded from the text files
+ScenarioSpec::ScenarioSpec(){
+    eventFile = "Events.txt";
+    generated = false;
+    numOfParties = 0;
+    numOfIssues = 0;
+    first = 0;
+    second = 0;
+    seed = 0;
 }
 
-// static array which holds 3 ints 0,1,2 which are used to randomise candidates/leaders
-// and ensure we dont select duplicate candidates/leaders.
-int RandomGenerator::shuffledArray[3] = {1, 2, 0};
+// function used to read a scenario from the --generate argument
+// the format is <distribution>:<first>:<second>[:<seed>] eg. uniform:20000:500000 or normal:100000:15000:7
+// the map seed defaults to the election seed when it isn't provided.
+// returns false if the scenario is not valid
+bool ScenarioSpec::parse(string spec, uint64_t defaultSeed){
 
-//function used to shuffle the static array.
-void RandomGenerator::shuffleArray(){
-    shuffle(shuffledArray, shuffledArray + 3, randomEngine);
-}
+    vector<string> parts;
+    stringstream specStream(spec);
+    string part;
 
-// function used for standardDeviation
-int RandomGenerator::standardDeviation(int charvalue, int deviation){
+    while(getline(specStream, part, ':')){
+        parts.push_back(part);
+    }
 
-    int result;
-    normal_distribution<double> dist(charvalue, deviation);
-    result = round(dist(randomEngine));
+    if(parts.size() < 3 || parts.size() > 4) return false;
+    if(parts[0] != "uniform" && parts[0] != "normal") return false;
 
-    return result;
+    try{
+        first = stoll(parts[1]);
+        second = stoll(parts[2]);
+        seed = parts.size() == 4 ? stoull(parts[3]) : defaultSeed;
+    }
+    catch(const exception&){
+        return false;
+    }
+
+    // populations have to be at most MAX_ELECTORATE_POPULATION so the population of every electorate adds up in 64 bits
+    if(first < 1 || second < 1 || first > MAX_ELECTORATE_POPULATION || second > MAX_ELECTORATE_POPULATION) return false;
+    if(parts[0] == "uniform" && first > second) return false;
+
+    distribution = parts[0];
+    generated = true;
+
+    return true;
 }
 
-/*  End of RandomGenerator functions */
+/*  End of ScenarioSpec functions */
 
 
-/*  Start of Stance functions */
-//Stance constructor
-Stance::Stance(Issue newIssue, int sig, int app) : issue(newIssue){
-    significance = sig;
-    approach = app;
+/*  Start of EventJournal functions */
+// the journal file starts with a magic string and version so other files aren't read as journals
+static const char journalMagic[4] = {'E', 'J', 'R', 'N'};
+static const uint32_t journalVersion = 5;
+
+// function used to write a value to the journal file as raw bytes
+template<typename T>
+static void writeJournalValue(ofstream& file, const T& value){
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
 }
 
-// function used to get approach
-int Stance::getApproach(){
-    return this->approach;
+// function used to read a value from the journal file as raw bytes
+template<typename T>
+static bool readJournalValue(ifstream& file, T& value){
+    return (bool)file.read(reinterpret_cast<char*>(&value), sizeof(T));
 }
 
-// function used to set approach
-// ensures that it never goes under 0 or above 100
-void Stance::setApproach(int newStanceApp){
-    if(newStanceApp > 100) approach = 100;
-    else if(newStanceApp < 0) approach = 0;
-    else approach = newStanceApp;
+// function used to write text to the journal file, the length is written before the text
+static void writeJournalText(ofstream& file, const string& value){
+    uint32_t length = value.size();
+    writeJournalValue(file, length);
+    file.write(value.data(), length);
 }
 
-// function used to get significance
-int Stance::getSignificance(){
-    return this->significance;
+// function used to read text written by writeJournalText
+static bool readJournalText(ifstream& file, string& value){
+    uint32_t length;
+    if(!readJournalValue(file, length) || length > 4096) return false;
+    value.resize(length);
+    return length == 0 || (bool)file.read(&value[0], length);
 }
 
-// function used to get Issue
-Issue Stance::getIssue(){
-    return this->issue;
+// function used to write the journal to a binary file
+// the header and scenario are written first then the records and stance changes as raw arrays.
+// returns false if the file couldn't be written
+bool EventJournal::save(const string& fileName){
+
+    ofstream file(fileName, ios::binary);
+    if(!file) return false;
+
+    file.write(journalMagic, sizeof(journalMagic));
+    writeJournalValue(file, journalVersion);
+    writeJournalValue(file, seed);
+    writeJournalValue(file, runNumber);
+    writeJournalValue(file, numOfElectorates);
+    writeJournalValue(file, numOfDays);
+
+    uint8_t generated = scenario.generated;
+    writeJournalText(file, scenario.eventFile);
+    writeJournalText(file, scenario.scenarioFile);
+    writeJournalValue(file, generated);
+    writeJournalValue(file, scenario.numOfParties);
+    writeJournalValue(file, scenario.numOfIssues);
+    writeJournalText(file, scenario.distribution);
+    writeJournalValue(file, scenario.first);
+    writeJournalValue(file, scenario.second);
+    writeJournalValue(file, scenario.seed);
+
+    uint64_t numOfRecords = records.size();
+    writeJournalValue(file, numOfRecords);
+    file.write(reinterpret_cast<const char*>(records.data()), numOfRecords * sizeof(EventRecord));
+
+    uint64_t numOfDeltas = stanceDeltas.size();
+    writeJournalValue(file, numOfDeltas);
+    file.write(reinterpret_cast<const char*>(stanceDeltas.data()), numOfDeltas);
+
+    return (bool)file;
 }
 
+// function used to read a journal written by save
+// returns false if the file can't be read or isn't a journal of this version,
+// or if a record holds anything that can't have been written by the campaign of the header.
+// the parties, issues and clusters aren't known until the election is generated so they are checked by Election::validateJournal.
+bool EventJournal::load(const string& fileName){
+
+    ifstream file(fileName, ios::binary | ios::ate);
+    if(!file) return false;
+    uint64_t fileSize = file.tellg();
+    file.seekg(0);
+
+    char magic[4];
+    uint32_t version;
+    if(!file.read(magic, sizeof(magic)) || !equal(magic, magic + 4, journalMagic)) return false;
+    if(!readJournalValue(file, version) || version != journalVersion) return false;
+
+    if(!readJournalValue(file, seed) || !readJournalValue(file, runNumber)) return false;
+    if(!readJournalValue(file, numOfElectorates) || !readJournalValue(file, numOfDays)) return false;
+
+    uint8_t generated;
+    if(!readJournalText(file, scenario.eventFile) || !readJournalText(file, scenario.scenarioFile)) return false;
+    if(!readJournalValue(file, generated) || !readJournalValue(file, scenario.numOfParties)) return false;
+    if(!readJournalValue(file, scenario.numOfIssues)) return false;
+    if(!readJournalText(file, scenario.distribution)) return false;
+    scenario.generated = generated;
+    if(!readJournalValue(file, scenario.first) || !readJournalValue(file, scenario.second)) return false;
+    if(!readJournalValue(file, scenario.seed)) return false;
+
+    if(numOfElectorates < 1 || numOfDays < 1) return false;
+
+    // the tables can't be longer than what is left of the file, so a truncated or foreign file isn't allocated for
+    uint64_t numOfRecords;
+    if(!readJournalValue(file, numOfRecords)) return false;
+    if(numOfRecords > (fileSize - file.tellg()) / sizeof(EventRecord)) return false;
+    records.resize(numOfRecords);
+    if(!file.read(reinterpret_cast<char*>(records.data()), numOfRecords * sizeof(EventRecord))) return false;
+
+    uint64_t numOfDeltas;
+    if(!readJournalValue(file, numOfDeltas)) return false;
+    if(numOfDeltas > fileSize - file.tellg()) return false;
+    stanceDeltas.resize(numOfDeltas);
+    if(!file.read(reinterpret_cast<char*>(stanceDeltas.data()), numOfDeltas)) return false;
+
+    // every record has to point inside the stance changes and only hold values the campaign can write
+    for(EventRecord& record : records){
+        if(record.firstStanceDelta > numOfDeltas || record.numOfStanceDeltas > numOfDeltas - record.firstStanceDelta) return false;
+        if(record.electorate < 0 || record.electorate >= numOfElectorates) return false;
+        if(record.day < 1 || record.day > numOfDays) return false;
+        if(record.influence > EventInfluence::NATIONAL) return false;
+        if(record.numOfCharChanges > MAX_CHARACTERISTIC_CHANGES) return false;
+        for(int x = 0; x < record.numOfCharChanges; x++){
+            CharacteristicChange& charChange = record.charChanges[x];
+            if(charChange.leader > 1 || charChange.characteristic >= NUM_OF_CHARACTERISTICS) return false;
+        }
+    }
 
-/*  Start of Person functions */
-// Person constructor
-Person::Person(string pName){
-    name = pName;
+    return true;
 }
 
-// Person default contructor
-Person::Person(){
-    name = "";
-}
+/*  End of EventJournal functions */
 
-// function used to get value of a Characteristic of a person
-unsigned int Person::getCharValue(Characteristic chr){
-    return characteristics.find(chr)->second;
-}
+/*  Start of ScenarioFile functions */
+// binary scenario files start with a magic string so other files aren't read as scenarios
+static const char scenarioMagic[4] = {'E', 'S', 'C', 'N'};
 
-// function used to upddate a Characteristic value
-void Person::updateChar(Characteristic chr, int value){
+// function used to round an offset in a scenario file up to the next multiple of 8
+static uint64_t alignScenario(uint64_t offset){
+    return (offset + 7) & ~(uint64_t)7;
+}
 
-    int updatedValue = characteristics.at(chr) + value;
+// function used to get the size of one column of the cluster tables
+static uint64_t clusterColumnSize(uint64_t numOfClusters, uint64_t valueSize){
+    return alignScenario(numOfClusters * valueSize);
+}
 
-    // ensures characteristic doesn't go higher than 100 or lower than 0
-    if(updatedValue > 100) characteristics.at(chr) = 100;
-    else if(updatedValue < 0)  characteristics.at(chr) = 0;
-    else characteristics.at(chr) += value;
+// function used to get the size of the cluster tables, population, electorate then approach and significance for each issue
+static uint64_t clusterTableSize(uint64_t numOfClusters, uint64_t numOfIssues){
+    return clusterColumnSize(numOfClusters, sizeof(int64_t)) + clusterColumnSize(numOfClusters, sizeof(int32_t)) + 2 * numOfIssues * clusterColumnSize(numOfClusters, sizeof(int16_t));
+}
 
+// ScenarioFile constructor, nothing is open until open is called
+ScenarioFile::ScenarioFile(){
+    data = nullptr;
+    size = 0;
+}
 
+// ScenarioFile destructor which unmaps the file
+ScenarioFile::~ScenarioFile(){
+    close();
 }
 
-// function used to print characteristics of a person
-void Person::printCharacteristics(){
+// function used to map a binary scenario file into memory and check it
+// returns false if the file can't be opened or isn't a valid scenario file
+bool ScenarioFile::open(const string& fileName){
 
-    map<Characteristic, unsigned int>::iterator it;
+    close();
 
-    for(it = characteristics.begin(); it != characteristics.end(); it++){
-        cout<<it->first<<": "<<it->second;
-        auto nextIt = it;
-        if(++nextIt != characteristics.end()){
-            cout<<", ";
-        }
+#ifdef ELECTION_MMAP
+    int file = ::open(fileName.c_str(), O_RDONLY);
+    if(file < 0) return false;
+
+    struct stat fileInfo;
+    if(fstat(file, &fileInfo) != 0 || fileInfo.st_size < (off_t)sizeof(ScenarioHeader)){
+        ::close(file);
+        return false;
     }
 
-}
+    void* mapping = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file); // the mapping stays once the file is closed
+    if(mapping == MAP_FAILED) return false;
+
+    // the tables are copied front to back so the kernel can read ahead
+    madvise(mapping, fileInfo.st_size, MADV_SEQUENTIAL);
+
+    data = static_cast<const char*>(mapping);
+    size = fileInfo.st_size;
+#else
+    ifstream file(fileName, ios::binary);
+    if(!file) return false;
+    buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+#endif
+
+    if(!check()){
+        close();
+        return false;
+    }
 
-// below are getters/setters for Person
-void Person::setName(string newName){
-    name = newName;
+    return true;
 }
 
-string Person::getName(){
-    return this->name;
+// function used to unmap the file
+void ScenarioFile::close(){
+#ifdef ELECTION_MMAP
+    if(data) munmap(const_cast<char*>(data), size);
+#endif
+    buffer.clear();
+    data = nullptr;
+    size = 0;
 }
 
-/*  Start of Candidate functions */
+// function used to check every table of the file fits in the file and every name and cluster in them is valid
+// the header is checked before anything it points to is read.
+bool ScenarioFile::check(){
+
+    if(size < sizeof(ScenarioHeader)) return false;
+
+    const ScenarioHeader& header = getHeader();
+
+    if(!equal(header.magic, header.magic + 4, scenarioMagic) || header.version != SCENARIO_VERSION) return false;
+    if(header.numOfIssues < (uint32_t)MIN_ISSUES || header.numOfIssues > (uint32_t)MAX_ISSUES) return false;
+    if(header.numOfParties < 2 || header.numOfParties > (uint32_t)MAX_PARTIES) return false;
+    if(header.numOfElectorates < 1 || header.numOfElectorates > INT32_MAX) return false;
+    if(header.numOfClusters < header.numOfElectorates || header.numOfClusters > INT32_MAX) return false;
+
+    // every table has to start on a multiple of 8 and end inside the file
+    uint64_t tables[7][2] = {
+        {header.textOffset, header.textSize},
+        {header.issueOffset, header.numOfIssues * sizeof(ScenarioIssue)},
+        {header.partyOffset, header.numOfParties * sizeof(ScenarioParty)},
+        {header.rangeOffset, header.numOfParties * header.numOfIssues * 4 * sizeof(int32_t)},
+        {header.electorateOffset, header.numOfElectorates * sizeof(ScenarioElectorate)},
+        {header.clusterOffset, clusterTableSize(header.numOfClusters, header.numOfIssues)},
+        {header.candidateOffset, header.numOfElectorates * header.numOfParties * sizeof(uint32_t)}
+    };
+    for(auto& table : tables){
+        if(table[0] % 8 != 0 || table[0] > size || table[1] > size - table[0]) return false;
+    }
 
-// Constructor specifically used to create leader candidate
-// Leaders characteristics will be random but at a higher range than other candidates
-Candidate::Candidate(string lName, int sRanges[5][4], vector<Issue> sIssues) : Person(lName){
-    // creates random obj to return random num
-    RandomGenerator random;
+    // the string pool has to end with a null so every name does
+    if(header.textSize == 0 || data[header.textOffset + header.textSize - 1] != '\0') return false;
 
-    // initialises votes/electorate and characteristics of leaders
-    totalVotes = 0;
-    electorateRepresented = "";
-    characteristics.insert(std::pair<Characteristic, int>(Characteristic::POPULARITY, random.randomIntRange(25, 30)));
-    characteristics.insert(std::pair<Characteristic, int>(Characteristic::CHARISMA, random.randomIntRange(25, 30)));
+    for(uint32_t issue = 0; issue < header.numOfIssues; issue++){
+        const ScenarioIssue& scenarioIssue = getIssues()[issue];
+        if(scenarioIssue.code >= header.textSize || scenarioIssue.statement >= header.textSize) return false;
+        if(scenarioIssue.type > static_cast<uint32_t>(IssueType::HEALTH)) return false;
+    }
 
-    int count = 0;
+    for(uint32_t party = 0; party < header.numOfParties; party++){
+        const ScenarioParty& scenarioParty = getParties()[party];
+        if(scenarioParty.name >= header.textSize || scenarioParty.leaderName >= header.textSize || scenarioParty.description >= header.textSize) return false;
 
-    // adds stances to leader
-    for(Issue& copyIssue : sIssues){
-        stances.push_back(Stance(Issue(copyIssue), random.randomIntRange(sRanges[count][0], sRanges[count][1]), random.randomIntRange(sRanges[count][2], sRanges[count][3])));
-        count++;
+        // each issue has a significance then an approach range
+        for(uint32_t issue = 0; issue < header.numOfIssues; issue++){
+            const int32_t* range = getStanceRanges(party) + issue * 4;
+            if(range[0] > range[1] || range[2] > range[3] || range[0] < 0 || range[3] > 100) return false;
+        }
     }
-}
 
-//Constructor for all other candidates
-Candidate::Candidate(string electorateName, string cName, int sRanges[5][4], vector<Issue> sIssues) : Person(cName){
-    RandomGenerator random;
+    // the clusters of the electorates have to follow each other and belong to the electorate
+    uint64_t nextCluster = 0;
+    const int32_t* clusterElectorates = getClusterElectorates();
+    for(uint64_t elecIndex = 0; elecIndex < header.numOfElectorates; elecIndex++){
+        const ScenarioElectorate& scenarioElectorate = getElectorates()[elecIndex];
+        if(scenarioElectorate.name >= header.textSize) return false;
+        if(scenarioElectorate.numOfClusters < 1 || scenarioElectorate.firstCluster != nextCluster) return false;
 
-    stancesWon = 0;
-    totalVotes = 0;
-    electorateRepresented = electorateName;
+        nextCluster += scenarioElectorate.numOfClusters;
+        if(nextCluster > header.numOfClusters) return false;
 
-    characteristics.insert(std::pair<Characteristic, int>(Characteristic::POPULARITY, random.randomIntRange(10, 15)));
-    characteristics.insert(std::pair<Characteristic, int>(Characteristic::CHARISMA, random.randomIntRange(10, 15)));
-    characteristics.insert(std::pair<Characteristic, int>(Characteristic::DEBATING, random.randomIntRange(10, 15)));
+        for(uint64_t cluster = scenarioElectorate.firstCluster; cluster < nextCluster; cluster++){
+            if(clusterElectorates[cluster] != (int32_t)elecIndex) return false;
+        }
+    }
+    if(nextCluster != header.numOfClusters) return false;
 
-    int count = 0;
-    for(Issue& copyIssue : sIssues){
-        stances.push_back(Stance(Issue(copyIssue), random.randomIntRange(sRanges[count][0], sRanges[count][1]), random.randomIntRange(sRanges[count][2], sRanges[count][3])));
-        count++;
+    const uint32_t* candidateNames = getCandidateNames();
+    for(uint64_t candidate = 0; candidate < header.numOfElectorates * header.numOfParties; candidate++){
+        if(candidateNames[candidate] >= header.textSize) return false;
     }
-}
 
-//Candidate default constructor
-Candidate::Candidate(){
-    totalVotes = 0;
-    stancesWon = 0;
+    return true;
 }
 
-//function used to print the stances of a candidate
-void Candidate::printStances(){
+// below getters for the tables of the file, they point straight into the mapped file
+const ScenarioHeader& ScenarioFile::getHeader(){
+    return *reinterpret_cast<const ScenarioHeader*>(data);
+}
 
-    int width = name.length();
-    cout<<setw(24-width);
-    for(Stance& stance : stances){
-        if(stance.getIssue().getIssueType() == IssueType::ECONOMIC) cout<<setw(24-width);
-        else if(stance.getIssue().getIssueType() == IssueType::ENVIRONMENTAL) cout<<setw(20);
-        else cout<<setw(16);
-        cout<<stance.getSignificance()<<"/"<<stance.getApproach();
-    }
-    cout<<endl;
+const char* ScenarioFile::getText(uint32_t offset){
+    return data + getHeader().textOffset + offset;
 }
 
-// function used to increment stancesWon
-void Candidate::updateStancesWon(){
-    stancesWon++;
+const ScenarioIssue* ScenarioFile::getIssues(){
+    return reinterpret_cast<const ScenarioIssue*>(data + getHeader().issueOffset);
 }
 
-// function used to calculate cluster votes based on stances won
-// stanceVotes based on 1/4 of population of current cluster
-void Candidate::calculateClusterVotes(int stanceVotes){
-    clusterVotes = stanceVotes * stancesWon;
+const ScenarioParty* ScenarioFile::getParties(){
+    return reinterpret_cast<const ScenarioParty*>(data + getHeader().partyOffset);
+}
 
-    updateTotalVotes(clusterVotes); // adds cluster votes to total votes
-    stancesWon = 0; // sets stancesWon to 0 after calculations have been completed
+// the 4 numbers of the StanceRange of each issue of the party, one issue after another
+const int32_t* ScenarioFile::getStanceRanges(int party){
+    const ScenarioHeader& header = getHeader();
+    return reinterpret_cast<const int32_t*>(data + header.rangeOffset) + party * header.numOfIssues * 4;
 }
 
-// function used to update the total votes of the candidate
-void Candidate::updateTotalVotes(int votes){
-    totalVotes += votes;
+const ScenarioElectorate* ScenarioFile::getElectorates(){
+    return reinterpret_cast<const ScenarioElectorate*>(data + getHeader().electorateOffset);
 }
 
+const int64_t* ScenarioFile::getPopulations(){
+    return reinterpret_cast<const int64_t*>(data + getHeader().clusterOffset);
+}
 
-// Below functions are setters/getters for candidate
-int Candidate::getTotalVotes(){
-    return this->totalVotes;
+const int32_t* ScenarioFile::getClusterElectorates(){
+    const ScenarioHeader& header = getHeader();
+    return reinterpret_cast<const int32_t*>(data + header.clusterOffset + clusterColumnSize(header.numOfClusters, sizeof(int64_t)));
 }
 
-int Candidate::getClusterVotes(){
-    return this->clusterVotes;
+const int16_t* ScenarioFile::getApproaches(int issue){
+    const ScenarioHeader& header = getHeader();
+    uint64_t offset = header.clusterOffset + clusterColumnSize(header.numOfClusters, sizeof(int64_t)) + clusterColumnSize(header.numOfClusters, sizeof(int32_t));
+    return reinterpret_cast<const int16_t*>(data + offset + issue * clusterColumnSize(header.numOfClusters, sizeof(int16_t)));
 }
 
+const int16_t* ScenarioFile::getSignificances(int issue){
+    return getApproaches(getHeader().numOfIssues + issue);
+}
 
-string Candidate::getElectorateName(){
-    return this->electorateRepresented;
+const uint32_t* ScenarioFile::getCandidateNames(){
+    return reinterpret_cast<const uint32_t*>(data + getHeader().candidateOffset);
 }
 
-vector<Stance>& Candidate::getStances(){
-    return this->stances;
+// function used to write a scenario file padded with zeros up to the offset of the next table
+static void padScenario(ofstream& file, uint64_t& position, uint64_t offset){
+    static const char zeros[8] = {0};
+    file.write(zeros, offset - position);
+    position = offset;
 }
 
-void Candidate::setRelatedParty(Party* party){
-    relatedParty = party;
+// function used to write a column of the scenario file and pad it to a multiple of 8
+static void writeScenarioTable(ofstream& file, uint64_t& position, const void* table, uint64_t tableSize){
+    file.write(static_cast<const char*>(table), tableSize);
+    position += tableSize;
+    padScenario(file, position, alignScenario(position));
 }
 
-Party* Candidate::getRelatedParty(){
-    return this->relatedParty;
+// function used to add a name to the string pool of a scenario file, returns its offset
+static uint32_t addScenarioText(string& text, const string& name){
+    uint32_t offset = text.size();
+    text += name;
+    text += '\0';
+    return offset;
 }
 
-/*  End of Candidate functions */
+// function used to write the electorates, clusters, parties and candidates of a generated election to a binary scenario file
+// returns false if the file couldn't be written
+bool ScenarioFile::write(const string& fileName, IssueRegistry& issues, vector<Party>& parties, vector<Electorate>& electorates, VoterStore& voters, CandidateTable& candidates){
 
-/*  Start of Party functions */
-// Party constructor
-Party::Party(string pName, Candidate lCandidate, int sRanges[5][4]){
-    name = pName;
-    leader = lCandidate;
-    electoratesWon = 0;
+    ofstream file(fileName, ios::binary);
+    if(!file) return false;
+
+    string text(1, '\0'); // offset 0 is an empty name
+    vector<ScenarioIssue> scenarioIssues(issues.getNumOfIssues());
+    vector<ScenarioParty> scenarioParties(parties.size());
+    vector<int32_t> stanceRanges;
+    vector<ScenarioElectorate> scenarioElectorates(electorates.size());
+    vector<uint32_t> candidateNames;
+
+    for(int issue = 0; issue < issues.getNumOfIssues(); issue++){
+        scenarioIssues[issue].code = addScenarioText(text, issues.getIssue(issue).getIssueCode());
+        scenarioIssues[issue].statement = addScenarioText(text, issues.getIssue(issue).getStatement());
+        scenarioIssues[issue].type = static_cast<uint32_t>(issues.getIssue(issue).getIssueType());
+    }
 
-    for(int x = 0; x < 5; x++){
-        for(int y = 0; y < 4; y++){
-            stanceRanges[x][y] = sRanges[x][y];
+    for(unsigned int partyIndex = 0; partyIndex < parties.size(); partyIndex++){
+        ScenarioParty& scenarioParty = scenarioParties[partyIndex];
+        scenarioParty.name = addScenarioText(text, parties[partyIndex].getName());
+        scenarioParty.leaderName = addScenarioText(text, parties[partyIndex].getLeader().getName());
+        scenarioParty.description = addScenarioText(text, parties[partyIndex].getDescription());
+        for(const StanceRange& range : *parties[partyIndex].stanceRanges){
+            stanceRanges.insert(stanceRanges.end(), range.begin(), range.end());
+        }
+    }
+
+    for(unsigned int elecIndex = 0; elecIndex < electorates.size(); elecIndex++){
+        scenarioElectorates[elecIndex].name = addScenarioText(text, electorates[elecIndex].getName());
+        scenarioElectorates[elecIndex].numOfClusters = electorates[elecIndex].getNumOfClusters();
+        scenarioElectorates[elecIndex].firstCluster = electorates[elecIndex].getFirstCluster();
+
+        for(unsigned int partyIndex = 0; partyIndex < parties.size(); partyIndex++){
+            candidateNames.push_back(addScenarioText(text, candidates.getCandidate(elecIndex, partyIndex).getName()));
         }
     }
-}
 
-// function used to add candidate to candidates Map
-// sets the new candidates related party to the current party its being added to
-void Party::loadCandidate(Candidate newCandidate){
+    ScenarioHeader header = ScenarioHeader();
+    copy(scenarioMagic, scenarioMagic + 4, header.magic);
+    header.version = SCENARIO_VERSION;
+    header.numOfIssues = voters.getNumOfIssues();
+    header.numOfParties = parties.size();
+    header.numOfElectorates = electorates.size();
+    header.numOfClusters = voters.getNumOfClusters();
+    header.textOffset = alignScenario(sizeof(ScenarioHeader));
+    header.textSize = text.size();
+    header.issueOffset = alignScenario(header.textOffset + header.textSize);
+    header.partyOffset = alignScenario(header.issueOffset + scenarioIssues.size() * sizeof(ScenarioIssue));
+    header.rangeOffset = alignScenario(header.partyOffset + scenarioParties.size() * sizeof(ScenarioParty));
+    header.electorateOffset = alignScenario(header.rangeOffset + stanceRanges.size() * sizeof(int32_t));
+    header.clusterOffset = alignScenario(header.electorateOffset + scenarioElectorates.size() * sizeof(ScenarioElectorate));
+    header.candidateOffset = header.clusterOffset + clusterTableSize(header.numOfClusters, header.numOfIssues);
+
+    uint64_t position = 0;
+    writeScenarioTable(file, position, &header, sizeof(header));
+    writeScenarioTable(file, position, text.data(), text.size());
+    writeScenarioTable(file, position, scenarioIssues.data(), scenarioIssues.size() * sizeof(ScenarioIssue));
+    writeScenarioTable(file, position, scenarioParties.data(), scenarioParties.size() * sizeof(ScenarioParty));
+    writeScenarioTable(file, position, stanceRanges.data(), stanceRanges.size() * sizeof(int32_t));
+    writeScenarioTable(file, position, scenarioElectorates.data(), scenarioElectorates.size() * sizeof(ScenarioElectorate));
+    writeScenarioTable(file, position, voters.getPopulations(), header.numOfClusters * sizeof(int64_t));
+    writeScenarioTable(file, position, voters.getElectorates(), header.numOfClusters * sizeof(int32_t));
+    for(uint32_t issue = 0; issue < header.numOfIssues; issue++){
+        writeScenarioTable(file, position, voters.getApproaches(issue), header.numOfClusters * sizeof(int16_t));
+    }
+    for(uint32_t issue = 0; issue < header.numOfIssues; issue++){
+        writeScenarioTable(file, position, voters.getSignificances(issue), header.numOfClusters * sizeof(int16_t));
+    }
+    writeScenarioTable(file, position, candidateNames.data(), candidateNames.size() * sizeof(uint32_t));
 
-    newCandidate.setRelatedParty(this);
-    candidates.insert(pair<string, Candidate>(newCandidate.getElectorateName(), newCandidate));
+    return (bool)file;
 }
 
-// function used to print party information
-void Party::printParty(){
-    cout<<"Stances (Sig/App)   ";
-    cout<<"COVID-19 Financial";
-    cout<<setw(15)<<"Sauce Debate";
-    cout<<setw(25)<<"Toilet Paper Shortage";
-    cout<<setw(17)<<"Global Warming";
-    cout<<setw(20)<<"Mandatory Vaccines";
-    cout<<endl;
-    cout<<"----------------------------------------------------------------------";
-    cout<<"-------------------------------------------"<<endl;
-    cout<<"Party(Ranges): ";
-    cout<<setw(9)<<stanceRanges[0][0]<<"-"<<stanceRanges[0][1]<<"/"<<stanceRanges[0][2]<<"-"<<stanceRanges[0][3];
-    cout<<setw(10)<<stanceRanges[1][0]<<"-"<<stanceRanges[1][1]<<"/"<<stanceRanges[1][2]<<"-"<<stanceRanges[1][3];
-    cout<<setw(11)<<stanceRanges[2][0]<<"-"<<stanceRanges[2][1]<<"/"<<stanceRanges[2][2]<<"-"<<stanceRanges[2][3];
-    cout<<setw(15)<<stanceRanges[3][0]<<"-"<<stanceRanges[3][1]<<"/"<<stanceRanges[3][2]<<"-"<<stanceRanges[3][3];
-    cout<<setw(9)<<stanceRanges[4][0]<<"-"<<stanceRanges[4][1]<<"/"<<stanceRanges[4][2]<<"-"<<stanceRanges[4][3];
-    cout<<endl;
+/*  End of ScenarioFile functions */
 
-    cout<<"Candidates "<<endl;
-    map<string, Candidate>::iterator it;
 
-    for(it = candidates.begin(); it != candidates.end(); it++){
-        cout<<it->second.getName()<<": ";
-        it->second.printStances();
+
+/*  Start of NarrationSink functions */
+// NarrationSink constructor which takes the level of messages to narrate and where to write them
+// the ring and writer thread are only set up if something is going to be narrated.
+NarrationSink::NarrationSink(NarrationLevel narrationLevel, FILE* narrationOutput){
+    level = narrationLevel;
+    output = narrationOutput;
+    ringSize = 4096;
+    addPos = 0;
+    writtenPos = 0;
+    flushPos = 0;
+    running = false;
+
+    if(level == NarrationLevel::SILENT) return;
+
+    // each slot starts free for the message with its own index
+    ring.reset(new Slot[ringSize]);
+    for(uint64_t x = 0; x < ringSize; x++){
+        ring[x].sequence.store(x, memory_order_relaxed);
     }
 
+    running = true;
+    writer = thread(&NarrationSink::runWriter, this);
 }
 
-// below functions are setters/getters for Party
-Candidate& Party::getLeader(){
-    return this->leader;
-}
+// NarrationSink destructor, writes out everything left and stops the writer thread
+NarrationSink::~NarrationSink(){
+    if(!writer.joinable()) return;
 
-string Party::getName(){
-    return this->name;
+    flush();
+    running = false;
+    writer.join();
 }
 
-map<string, Candidate>& Party::getCandidates(){
-    return this->candidates;
-}
+// function used to add a message to the ring
+// the slot for the message is claimed by moving addPos on, if the ring is full
+// the thread waits for the writer to free up the slot.
+void NarrationSink::addRecord(NarrationRecord& record){
 
-ManagerialTeam& Party::getManagerialTeam(){
-    return this->mngTeam;
+    uint64_t pos = addPos.load(memory_order_relaxed);
+    Slot* slot;
+
+    while(true){
+        slot = &ring[pos & (ringSize - 1)];
+        uint64_t sequence = slot->sequence.load(memory_order_acquire);
+        int64_t difference = (int64_t)sequence - (int64_t)pos;
+
+        if(difference == 0){
+            if(addPos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+        }
+        else if(difference < 0){
+            // the ring is full
+            this_thread::yield();
+            pos = addPos.load(memory_order_relaxed);
+        }
+        else pos = addPos.load(memory_order_relaxed);
+    }
+
+    slot->record = record;
+    slot->sequence.store(pos + 1, memory_order_release);
 }
 
-// used to increment electoratesWon
-void Party::updateElectoratesWon(){
-    electoratesWon++;
+// function run by the writer thread
+// takes each message out of the ring in order and formats it into the block,
+// the block is written once it is large or when a flush has asked for everything to be written.
+void NarrationSink::runWriter(){
+
+    const size_t blockSize = 1 << 16;
+    string block;
+    block.reserve(blockSize * 2);
+    uint64_t readPos = 0;
+
+    while(true){
+        Slot& slot = ring[readPos & (ringSize - 1)];
+
+        if(slot.sequence.load(memory_order_acquire) == readPos + 1){
+            formatRecord(slot.record, block);
+            slot.sequence.store(readPos + ringSize, memory_order_release);
+            readPos++;
+
+            if(block.size() >= blockSize){
+                fwrite(block.data(), 1, block.size(), output);
+                block.clear();
+            }
+            continue;
+        }
+
+        // the ring is empty, writes everything out if a flush is waiting
+        if(flushPos.load(memory_order_acquire) > writtenPos.load(memory_order_relaxed)){
+            fwrite(block.data(), 1, block.size(), output);
+            fflush(output);
+            block.clear();
+            writtenPos.store(readPos, memory_order_release);
+        }
+        else if(!running.load(memory_order_acquire)) break;
+        else this_thread::sleep_for(chrono::microseconds(100));
+    }
 }
 
-int Party::getElectoratesWon(){
-    return this->electoratesWon;
+// function used to fill in the placeholders of a message and add it to the block
+// each %s or %d is replaced by the next argument and %% is a single %.
+void NarrationSink::formatRecord(NarrationRecord& record, string& block){
+
+    int nextArg = 0;
+    char number[24];
+
+    for(const char* c = record.format; *c != '\0'; c++){
+        if(*c == '%' && (c[1] == 's' || c[1] == 'd') && nextArg < record.numOfArgs){
+            NarrationArg& arg = record.args[nextArg++];
+            if(arg.isText) block += arg.text;
+            else block.append(number, snprintf(number, sizeof(number), "%lld", (long long)arg.number));
+            c++;
+        }
+        else if(*c == '%' && c[1] == '%'){
+            block += '%';
+            c++;
+        }
+        else block += *c;
+    }
 }
 
-/*  End of Party functions */
+// function used to write out everything narrated so far
+// waits until the writer has written every message that was added before the flush
+void NarrationSink::flush(){
+    if(!writer.joinable()) return;
 
+    uint64_t target = addPos.load(memory_order_acquire);
+    uint64_t current = flushPos.load(memory_order_relaxed);
+    while(current < target && !flushPos.compare_exchange_weak(current, target));
 
-/*  Start of ManagerialTeam functions */
-// constructer for ManagerialTeam
-ManagerialTeam::ManagerialTeam(string mname){
+    while(writtenPos.load(memory_order_acquire) < target){
+        this_thread::yield();
+    }
+}
 
-    RandomGenerator random;
+// below functions turn the values given to narrate into NarrationArgs
+NarrationArg NarrationSink::makeArg(const char* text){
+    NarrationArg arg;
+    arg.isText = true;
+    arg.text = text;
+    arg.number = 0;
+    return arg;
+}
 
-    name = mname + " Managerial Team";
-    characteristics.insert(std::pair<Characteristic, int>(Characteristic::EVENTHANDLE, random.randomIntRange(1,5)));
+NarrationArg NarrationSink::makeArg(const string& text){
+    return makeArg(text.c_str());
 }
-// default constructor for ManagerialTeam
-ManagerialTeam::ManagerialTeam(){
 
-     RandomGenerator random;
+NarrationArg NarrationSink::makeArg(int64_t number){
+    NarrationArg arg;
+    arg.isText = false;
+    arg.text = nullptr;
+    arg.number = number;
+    return arg;
+}
 
-     characteristics.insert(std::pair<Characteristic, int>(Characteristic::EVENTHANDLE, random.randomIntRange(1,5)));
+NarrationLevel NarrationSink::getLevel(){
+    return this->level;
 }
 
-/*  End of ManagerialTeam functions */
+/*  End of NarrationSink functions */
+
 
 
-/*  Start of Event functions */
-// static int to keep track of total number of events, sets the currrent numOfEvents to eventCode identifier in constructor
-int Event::numOfEvents = 0;
+/*  Start of BatchSimulator functions */
+// BatchSimulator constructor which takes numOfElectorates, numOfDays, the number of runs,
+// the number of worker threads to use and the seed shared by every run
+BatchSimulator::BatchSimulator(int electorates, int days, int runs, int threads, uint64_t batchSeed){
+    seed = batchSeed;
+    numOfElectorates = electorates;
+    numOfDays = days;
+    numOfRuns = runs;
+    numOfThreads = threads;
+    hungParliaments = 0;
+    campaignOrder = CampaignOrder::DAY_MAJOR;
+    branchDay = -1;
+    recordRuns = false;
+    nextRun = 0;
+}
 
-// constructor for Event
-Event::Event(EventType event, string statement, int range, Characteristic chr){
-    type = event;
-    eventStatement = statement;
-    impactRange = range;
-    impactChar = chr;
-    eventCode = numOfEvents;
-    numOfEvents++;
+// function used to set the scenario every election of the batch is generated from
+void BatchSimulator::setScenario(ScenarioSpec newScenario){
+    scenario = newScenario;
 }
 
-// below getters/setters for Event
-string Event::getStatement() {
-    return this->eventStatement;
-};
+// function used to set the order every election of the batch runs its campaign in
+void BatchSimulator::setCampaignOrder(CampaignOrder order){
+    campaignOrder = order;
+}
 
-Characteristic Event::getImpactedChar(){
-    return this->impactChar;
+// function used to make every run of the batch branch from the same election at the end of a campaign day
+void BatchSimulator::setBranchDay(int day){
+    branchDay = day;
 }
 
-int Event::getImpactRange(){
-    return this->impactRange;
+// function used to keep the result of every run of the batch as well as the totals
+void BatchSimulator::setRecordRuns(bool record){
+    recordRuns = record;
 }
 
-void Event::setRelatedIssue(IssueType issue){
-    relatedIssue = issue;
+// function used to run all elections of the batch
+// starts the worker threads and waits for all of them to finish
+// when branching the trunk is generated and run up to the branch day first, once for the whole batch.
+void BatchSimulator::runBatch(){
+
+    vector<thread> workers;
+
+    if(recordRuns) runResults.assign(numOfRuns, BatchRunResult());
+
+    if(branchDay >= 0){
+        trunk.reset(new Election(numOfElectorates, numOfDays, seed, 0, NarrationLevel::SILENT));
+        trunk->setScenario(scenario);
+        trunk->setCampaignOrder(campaignOrder);
+        trunk->generateElection();
+        trunk->runCampaign(branchDay);
+        branchPoint = trunk->snapshot();
+
+        // the days of the trunk are shared by every run so they are only counted once, not as an election of their own
+        ElectionStats& trunkStats = trunk->getStats();
+        trunkStats.elections = 0;
+        stats.add(trunkStats);
+    }
+
+    // never start more workers than there are runs
+    int threadCount = min(numOfThreads, numOfRuns);
+
+    for(int x = 0; x < threadCount; x++){
+        workers.push_back(thread(&BatchSimulator::runWorker, this));
+    }
+
+    for(thread& worker : workers){
+        worker.join();
+    }
 }
 
-IssueType Event::getIssueType(){
-    return relatedIssue;
+// function run by each worker thread
+// keeps taking the next run number until all runs have been taken
+// results are kept locally and then added to the batch totals at the end
+// so the workers only ever lock once.
+// when branching the worker forks the trunk once and restores the fork to the branch point for each run,
+// which carries on with the random streams of the run, so nothing is generated or allocated again.
+void BatchSimulator::runWorker(){
+
+    vector<vector<long>> localSeatCounts;
+    vector<vector<long>> localElectorateWins;
+    vector<long> localElectionsWon;
+    long localHungParliaments = 0;
+    vector<string> localPartyNames;
+    vector<string> localElectorateNames;
+    ElectionStats localStats;
+    int runNumber;
+    unique_ptr<Election> branch; // the fork of the trunk this worker runs its branches on
+    int branchRuns = 0;
+
+    if(trunk) branch = trunk->fork(0);
+
+    // each election uses the batch seed and its run number for its random streams
+    // so the results don't depend on which thread ran it
+    while((runNumber = nextRun++) < numOfRuns){
+
+        unique_ptr<Election> newElection; // the election of the run when not branching
+        if(branch){
+            branch->restore(branchPoint, runNumber);
+            branchRuns++;
+        }
+        else{
+            newElection.reset(new Election(numOfElectorates, numOfDays, seed, runNumber, NarrationLevel::SILENT));
+            newElection->setScenario(scenario);
+            newElection->setCampaignOrder(campaignOrder);
+            newElection->generateElection();
+        }
+
+        Election& election = branch ? *branch : *newElection;
+        election.runElection();
+        election.finishElection();
+
+        vector<Party>& parties = election.getParties();
+
+        // sets up the local totals on the first run now the parties/electorates are known
+        if(localPartyNames.empty()){
+            for(Party& currentParty : parties){
+                localPartyNames.push_back(currentParty.getName());
+            }
+            for(Electorate& currentElectorate : election.getElectorates()){
+                localElectorateNames.push_back(currentElectorate.getName());
+            }
+            localSeatCounts.assign(parties.size(), vector<long>(numOfElectorates + 1, 0));
+            localElectorateWins.assign(numOfElectorates, vector<long>(parties.size(), 0));
+            localElectionsWon.assign(parties.size(), 0);
+        }
+
+        for(unsigned int x = 0; x < parties.size(); x++){
+            localSeatCounts[x][parties[x].getElectoratesWon()]++;
+        }
+
+        vector<int>& winners = election.getElectorateWinners();
+        for(unsigned int x = 0; x < winners.size(); x++){
+            localElectorateWins[x][winners[x]]++;
+        }
+
+        if(election.isHungParliament()) localHungParliaments++;
+        else localElectionsWon[election.getWinningParty()]++;
+
+        if(recordRuns){
+            BatchRunResult& result = runResults[runNumber];
+            result.electorateWinners = winners;
+            for(Party& currentParty : parties){
+                result.electoratesWon.push_back(currentParty.getElectoratesWon());
+            }
+            result.hungParliament = election.isHungParliament();
+            result.winningParty = result.hungParliament ? -1 : election.getWinningParty();
+        }
+
+        if(!branch) localStats.add(election.getStats());
+    }
+
+    // the branch counts every run made on it into its stats
+    if(branch){
+        ElectionStats& branchStats = branch->getStats();
+        branchStats.elections = branchRuns;
+        localStats.add(branchStats);
+    }
+
+    // worker never ran an election
+    if(localPartyNames.empty()) return;
+
+    // adds the local totals to the batch totals
+    lock_guard<mutex> lock(resultsLock);
+
+    if(partyNames.empty()){
+        partyNames = localPartyNames;
+        electorateNames = localElectorateNames;
+        seatCounts = localSeatCounts;
+        electorateWins = localElectorateWins;
+        electionsWon = localElectionsWon;
+    }
+    else{
+        for(unsigned int x = 0; x < seatCounts.size(); x++){
+            for(unsigned int y = 0; y < seatCounts[x].size(); y++){
+                seatCounts[x][y] += localSeatCounts[x][y];
+            }
+            electionsWon[x] += localElectionsWon[x];
+        }
+        for(unsigned int x = 0; x < electorateWins.size(); x++){
+            for(unsigned int y = 0; y < electorateWins[x].size(); y++){
+                electorateWins[x][y] += localElectorateWins[x][y];
+            }
+        }
+    }
+    hungParliaments += localHungParliaments;
+    stats.add(localStats);
+}
+
+// function used to print the aggregated results of the batch
+// prints the seat distribution of each party, the hung parliament rate
+// and the chance of each party winning each electorate
+void BatchSimulator::reportBatch(){
+
+    cout<<"=======================Election Simulator Batch Results======================="<<endl;
+    cout<<numOfRuns<<" elections with "<<numOfElectorates<<" electorates over "<<numOfDays<<" campaign days (seed "<<seed<<")\n"<<endl;
+    if(branchDay >= 0) cout<<"Every election branches from the same election at the end of day "<<branchDay<<"\n"<<endl;
+
+    cout<<fixed<<setprecision(2);
+
+    cout<<"                              ~~~~SEATS~~~\n"<<endl;
+    for(unsigned int x = 0; x < partyNames.size(); x++){
+        double totalSeats = 0;
+        for(unsigned int seats = 0; seats < seatCounts[x].size(); seats++){
+            totalSeats += seats * seatCounts[x][seats];
+        }
+
+        cout<<partyNames[x]<<": average seats "<<totalSeats/numOfRuns;
+        cout<<", won "<<(100.0 * electionsWon[x])/numOfRuns<<"% of elections"<<endl;
+
+        // only seat counts that happened are printed so large scenarios stay readable
+        cout<<"Seat distribution (seats: % of runs): ";
+        bool firstSeats = true;
+        for(unsigned int seats = 0; seats < seatCounts[x].size(); seats++){
+            if(seatCounts[x][seats] == 0) continue;
+            if(!firstSeats) cout<<", ";
+            cout<<seats<<": "<<(100.0 * seatCounts[x][seats])/numOfRuns;
+            firstSeats = false;
+        }
+        cout<<"\n"<<endl;
+    }
+
+    cout<<"Hung parliament rate: "<<(100.0 * hungParliaments)/numOfRuns<<"%\n"<<endl;
+
+    cout<<"                              ~~~~Electorates~~~\n"<<endl;
+    cout<<"Chance of winning each electorate:"<<endl;
+    for(unsigned int x = 0; x < electorateNames.size(); x++){
+        cout<<electorateNames[x]<<": ";
+        for(unsigned int y = 0; y < partyNames.size(); y++){
+            cout<<partyNames[y]<<" "<<(100.0 * electorateWins[x][y])/numOfRuns<<"%";
+            if(y + 1 < partyNames.size()) cout<<", ";
+        }
+        cout<<endl;
+    }
+}
+
+// function used to get the stats of every election of the batch, only complete once runBatch has finished
+ElectionStats& BatchSimulator::getStats(){
+    return stats;
+}
+
+// function used to get the result of every run of the batch in run order, only filled in when the batch records its runs
+vector<BatchRunResult>& BatchSimulator::getRunResults(){
+    return runResults;
+}
+
+/*  End of BatchSimulator functions */
+
+
+/*  Start of BatchRunResult functions */
+// BatchRunResult constructor, the result is empty until the run has finished
+BatchRunResult::BatchRunResult(){
+    winningParty = -1;
+    hungParliament = false;
+}
+
+/*  End of BatchRunResult functions */
+
+
+/*  Start of ElectionStats functions */
+
+// the names of the phases and event types used when printing the stats
+static const char* statsPhaseNames[NUM_OF_STATS_PHASES] = {"generateElection", "runCampaign", "calculatePopularity", "tallyVotes", "determineWinner"};
+static const char* statsEventNames[NUM_OF_EVENT_TYPES] = {"debate", "candidate", "leader", "issue"};
+
+// ElectionStats constructor, every counter starts at 0
+ElectionStats::ElectionStats(){
+    elections = 0;
+    for(int x = 0; x < NUM_OF_STATS_PHASES; x++){
+        phaseNanos[x] = 0;
+        phaseCalls[x] = 0;
+    }
+    for(int x = 0; x < NUM_OF_EVENT_TYPES; x++) eventsByType[x] = 0;
+    influenceCalls = 0;
+    clustersTouched = 0;
+    randomDraws = 0;
+}
+
+// function used to add the stats of another election or batch worker to these stats
+void ElectionStats::add(ElectionStats& other){
+    elections += other.elections;
+    for(int x = 0; x < NUM_OF_STATS_PHASES; x++){
+        phaseNanos[x] += other.phaseNanos[x];
+        phaseCalls[x] += other.phaseCalls[x];
+    }
+    for(int x = 0; x < NUM_OF_EVENT_TYPES; x++) eventsByType[x] += other.eventsByType[x];
+    influenceCalls += other.influenceCalls;
+    clustersTouched += other.clustersTouched;
+    randomDraws += other.randomDraws;
+}
+
+// function used to print a summary of the stats
+// the time of each phase is added up over every election, so a batch run on several threads
+// can spend longer in its phases than the batch took.
+void ElectionStats::printStats(){
+
+    cout<<"=======================Election Simulator Stats======================="<<endl;
+    cout<<elections<<" election(s)\n"<<endl;
+
+    cout<<fixed<<setprecision(3);
+    cout<<left<<setw(24)<<"Phase"<<right<<setw(10)<<"Calls"<<setw(16)<<"Total (ms)"<<setw(16)<<"Mean (ms)"<<endl;
+    for(int x = 0; x < NUM_OF_STATS_PHASES; x++){
+        double totalMs = phaseNanos[x] / 1e6;
+        cout<<left<<setw(24)<<statsPhaseNames[x]<<right<<setw(10)<<phaseCalls[x]<<setw(16)<<totalMs;
+        cout<<setw(16)<<(phaseCalls[x] ? totalMs / phaseCalls[x] : 0.0)<<endl;
+    }
+
+    cout<<"\nEvents: ";
+    for(int x = 0; x < NUM_OF_EVENT_TYPES; x++){
+        cout<<statsEventNames[x]<<" "<<eventsByType[x];
+        if(x + 1 < NUM_OF_EVENT_TYPES) cout<<", ";
+    }
+    cout<<endl;
+    cout<<"Influence calls: "<<influenceCalls<<", clusters touched: "<<clustersTouched<<endl;
+    cout<<"Random draws: "<<randomDraws<<endl;
+}
+
+// function used to write the stats to a JSON file
+// times are written in nanoseconds so nothing is lost to rounding.
+// returns false if the file can't be written
+bool ElectionStats::writeJson(const string& fileName){
+
+    ofstream file(fileName);
+    if(!file.is_open()) return false;
+
+    file<<"{\n  \"elections\": "<<elections<<",\n  \"phases\": {\n";
+    for(int x = 0; x < NUM_OF_STATS_PHASES; x++){
+        file<<"    \""<<statsPhaseNames[x]<<"\": {\"calls\": "<<phaseCalls[x]<<", \"nanoseconds\": "<<phaseNanos[x]<<"}";
+        file<<(x + 1 < NUM_OF_STATS_PHASES ? ",\n" : "\n");
+    }
+    file<<"  },\n  \"events\": {";
+    for(int x = 0; x < NUM_OF_EVENT_TYPES; x++){
+        file<<"\""<<statsEventNames[x]<<"\": "<<eventsByType[x]<<(x + 1 < NUM_OF_EVENT_TYPES ? ", " : "");
+    }
+    file<<"},\n  \"influenceCalls\": "<<influenceCalls<<",\n  \"clustersTouched\": "<<clustersTouched;
+    file<<",\n  \"randomDraws\": "<<randomDraws<<"\n}\n";
+
+    return file.good();
+}
+
+// PhaseTimer constructor which starts timing the phase
+PhaseTimer::PhaseTimer(ElectionStats& phaseStats, StatsPhase timedPhase) : stats(phaseStats), phase(timedPhase){
+    start = chrono::steady_clock::now();
+}
+
+// PhaseTimer destructor which adds the time since it was created to its phase
+PhaseTimer::~PhaseTimer(){
+    int phaseIndex = static_cast<int>(phase);
+    stats.phaseNanos[phaseIndex] += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    stats.phaseCalls[phaseIndex]++;
+}
+
+/*  End of ElectionStats functions */
+
+
+/*  Start of CampaignScheduler functions */
+
+// CampaignWorker constructor, the generator is keyed the same as the elections so it rolls the same streams
+CampaignWorker::CampaignWorker(uint64_t seed, uint32_t runNumber) : random(seed, runNumber){
+    record = EventRecord();
+}
+
+// CampaignScheduler constructor which starts a thread for every worker but the first
+// the first worker is the thread that runs the segments
+CampaignScheduler::CampaignScheduler(Election& campaignElection, int workers) : election(campaignElection){
+    numOfWorkers = max(1, workers);
+    shares.reset(new WorkShare[numOfWorkers]);
+    for(int worker = 0; worker < numOfWorkers; worker++){
+        shares[worker].chunks = 0;
+    }
+    segmentNumber = 0;
+    busyWorkers = 0;
+    stopping = false;
+    task = nullptr;
+    rangeTask = nullptr;
+    firstElectorate = 0;
+    lastElectorate = 0;
+    chunkSize = minCampaignChunk;
+
+    for(int worker = 1; worker < numOfWorkers; worker++){
+        threads.push_back(thread(&CampaignScheduler::runThread, this, worker));
+    }
+}
+
+// CampaignScheduler destructor which stops the worker threads and waits for them to finish
+CampaignScheduler::~CampaignScheduler(){
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    segmentStarted.notify_all();
+
+    for(thread& worker : threads){
+        worker.join();
+    }
+}
+
+// function used to run the task for every electorate from first up to last on all of the workers
+// returns once every electorate has been run
+void CampaignScheduler::runSegment(void (Election::*segmentTask)(int, int), int first, int last){
+    task = segmentTask;
+    rangeTask = nullptr;
+    runChunks(first, last);
+}
+
+// function used to run the task for every chunk of electorates from first up to last on all of the workers
+// returns once every chunk has been run
+void CampaignScheduler::runSegment(void (Election::*segmentTask)(int, int, int), int first, int last){
+    task = nullptr;
+    rangeTask = segmentTask;
+    runChunks(first, last);
+}
+
+// function used to split the electorates from first up to last into chunks and run them on all of the workers
+void CampaignScheduler::runChunks(int first, int last){
+
+    if(first >= last) return;
+
+    int numOfElectorates = last - first;
+    chunkSize = max(minCampaignChunk, numOfElectorates / (numOfWorkers * campaignChunksPerWorker));
+    int numOfChunks = (numOfElectorates + chunkSize - 1) / chunkSize;
+
+    // each share holds its front chunk in the low 32 bits and the chunk after its back chunk in the high 32 bits
+    for(int worker = 0; worker < numOfWorkers; worker++){
+        uint64_t front = (uint64_t)numOfChunks * worker / numOfWorkers;
+        uint64_t back = (uint64_t)numOfChunks * (worker + 1) / numOfWorkers;
+        shares[worker].chunks.store(front | (back << 32), memory_order_relaxed);
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        firstElectorate = first;
+        lastElectorate = last;
+        busyWorkers = numOfWorkers - 1;
+        segmentNumber++;
+    }
+    segmentStarted.notify_all();
+
+    runShare(0);
+
+    unique_lock<mutex> guard(lock);
+    while(busyWorkers > 0) segmentFinished.wait(guard);
+}
+
+// function run by each worker thread, waits for a segment, runs its share then waits for the next one
+void CampaignScheduler::runThread(int worker){
+
+    uint64_t lastSegment = 0;
+
+    while(true){
+        {
+            unique_lock<mutex> guard(lock);
+            while(segmentNumber == lastSegment && !stopping) segmentStarted.wait(guard);
+            if(stopping) return;
+            lastSegment = segmentNumber;
+        }
+
+        runShare(worker);
+
+        lock_guard<mutex> guard(lock);
+        if(--busyWorkers == 0) segmentFinished.notify_one();
+    }
+}
+
+// function used to run the task for every electorate of the chunks a worker takes or steals
+void CampaignScheduler::runShare(int worker){
+    int chunk;
+    while(takeChunk(worker, chunk)){
+        int first = firstElectorate + chunk * chunkSize;
+        int last = min(lastElectorate, first + chunkSize);
+        if(rangeTask){
+            (election.*rangeTask)(worker, first, last);
+            continue;
+        }
+        for(int elecIndex = first; elecIndex < last; elecIndex++){
+            (election.*task)(worker, elecIndex);
+        }
+    }
+}
+
+// function used to get the next chunk for a worker, from the front of its own share
+// or from the back of another workers share once its own is empty.
+// returns false when every share is empty
+bool CampaignScheduler::takeChunk(int worker, int& chunk){
+
+    uint64_t chunks = shares[worker].chunks.load(memory_order_relaxed);
+    while((uint32_t)chunks < (uint32_t)(chunks >> 32)){
+        if(shares[worker].chunks.compare_exchange_weak(chunks, chunks + 1, memory_order_relaxed)){
+            chunk = (uint32_t)chunks;
+            return true;
+        }
+    }
+
+    for(int offset = 1; offset < numOfWorkers; offset++){
+        WorkShare& victim = shares[(worker + offset) % numOfWorkers];
+        chunks = victim.chunks.load(memory_order_relaxed);
+        while((uint32_t)chunks < (uint32_t)(chunks >> 32)){
+            uint64_t back = (chunks >> 32) - 1;
+            if(victim.chunks.compare_exchange_weak(chunks, (uint32_t)chunks | (back << 32), memory_order_relaxed)){
+                chunk = back;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// DeferredInfluence constructor, there is no influence until a leader event keeps one
+DeferredInfluence::DeferredInfluence() : stance(0, 0, 0), random(0, 0){
+    day = 0;
+    electorate = -1;
+    influence = EventInfluence::NONE;
+    positive = false;
+    stances = nullptr;
+    draws = random.getNumOfDraws();
+}
+
+/*  End of CampaignScheduler functions */
+
+
+
+/*  Start of Issue functions */
+// constructor for Issue
+Issue::Issue(int issueID, string iCode, string issueStatement, IssueType typeIssue){
+    id = issueID;
+    statement = issueStatement;
+    type = typeIssue;
+    code = iCode;
+}
+
+//copy constructor for Issue
+Issue::Issue(const Issue &issueCopy){
+    id = issueCopy.id;
+    type = issueCopy.type;
+    statement = issueCopy.statement;
+    code = issueCopy.code;
+}
+
+// print function for Issue
+void Issue::printIssue(){
+    cout<<code<<":"<<endl;
+    cout<<statement<<endl;
+}
+
+// Below are getters/setters needed
+const string& Issue::getStatement(){
+    return this->statement;
+}
+
+IssueType& Issue::getIssueType(){
+    return this->type;
+}
+
+int Issue::getID(){
+    return this->id;
+}
+
+const string& Issue::getIssueCode(){
+    return this->code;
+}
+
+/*  Start of IssueRegistry functions */
+// IssueRegistry constructor, the registry starts empty
+IssueRegistry::IssueRegistry(){
+    issues = make_shared<vector<Issue>>();
+}
+
+// function used to add an issue to the registry
+// if an issue with the same code has already been added its id is returned instead
+// returns the id of the issue
+int IssueRegistry::internIssue(string iCode, string issueStatement, IssueType typeIssue){
+
+    int existingIssue = findIssue(iCode);
+    if(existingIssue != -1) return existingIssue;
+
+    // the issues of a fork are copied before they are added to
+    if(issues.use_count() > 1) issues = make_shared<vector<Issue>>(*issues);
+
+    issues->push_back(Issue(issues->size(), iCode, issueStatement, typeIssue));
+    return issues->size() - 1;
+}
+
+// function used to find the id of an issue from its code
+// returns -1 if the issue hasn't been added
+int IssueRegistry::findIssue(const string& iCode){
+    for(Issue& issue : *issues){
+        if(issue.getIssueCode() == iCode) return issue.getID();
+    }
+    return -1;
+}
+
+// below functions are getters for IssueRegistry
+Issue& IssueRegistry::getIssue(int issueID){
+    return (*issues)[issueID];
+}
+
+int IssueRegistry::getNumOfIssues(){
+    return issues->size();
+}
+
+// function used to get the width of the column of an issue when stances are printed in a table
+// the column fits the code of the issue and the widest stance range (eg. 10-10/100-100).
+int IssueRegistry::getColumnWidth(int issueID){
+    const int rangeWidth = 13;
+    return max((int)(*issues)[issueID].getIssueCode().length(), rangeWidth) + 3;
+}
+
+// function used to print the code of every issue as the heading of a table of stances
+void IssueRegistry::printIssueCodes(){
+    for(int issue = 0; issue < getNumOfIssues(); issue++){
+        cout<<setw(getColumnWidth(issue))<<(*issues)[issue].getIssueCode();
+    }
+    cout<<endl;
+}
+
+/*  End of IssueRegistry functions */
+
+/*  Start of Electorate functions */
+//Electorate constructor
+Electorate::Electorate(int elecID, string eName, int64_t totalPop){
+    id = elecID;
+    name = make_shared<const string>(eName);
+    totalPopulation = totalPop;
+    firstCluster = 0;
+    numOfClusters = 0;
+}
+
+// function used to set the clusters of the electorate when they are loaded all at once
+void Electorate::setClusters(int first, int count){
+    firstCluster = first;
+    numOfClusters = count;
+}
+
+// function used to add a cluster to the electorate
+// cluster is the index of the cluster in the elections VoterStore
+// clusters are added in order so only the first index needs to be kept.
+void Electorate::addCluster(int cluster){
+    if(numOfClusters == 0) firstCluster = cluster;
+    numOfClusters++;
+}
+
+// function used to print electorate information
+void Electorate::printElectorate(VoterStore& voters, IssueRegistry& issues){
+
+    cout<<*name<<" (Population: "<<totalPopulation<<")"<<endl;
+    cout<<"~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~";
+    cout<<"~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~"<<endl;
+    cout<<left<<setw(clusterLabelWidth)<<"Stances (Sig/App)"<<right;
+    issues.printIssueCodes();
+    cout<<"----------------------------------------------------------------------";
+    cout<<"------------------------------------------------------------------"<<endl;
+    printClusters(voters, issues);
+
+}
+
+// function used to print all clusters for an electorate
+void Electorate::printClusters(VoterStore& voters, IssueRegistry& issues){
+
+        int count = 1;
+        for(int cluster = firstCluster; cluster < firstCluster + numOfClusters; cluster++){
+            string label = "Cluster #" + to_string(count) + " (" + to_string(voters.getPopulation(cluster)) + " people)";
+            cout<<left<<setw(clusterLabelWidth)<<label<<right;
+            voters.printStances(cluster, issues);
+            count++;
+        }
+}
+
+// below functions are getters/setters for Electorate
+int Electorate::getID(){
+    return this->id;
+}
+
+const string& Electorate::getName(){
+    return *this->name;
+}
+
+int64_t Electorate::getPopulation(){
+    return this->totalPopulation;
+}
+
+void Electorate::setPopulation(int64_t pop){
+    this->totalPopulation = pop;
+}
+
+int Electorate::getFirstCluster(){
+    return this->firstCluster;
+}
+
+int Electorate::getNumOfClusters(){
+    return this->numOfClusters;
+}
+
+//function used to influence each stance of an electorate
+// random is the elections randomGenerator used to provide random stance range to update
+// between 1-3
+// if it is a positive impact the stances are updated to be more aligned with the candidates,
+// otherwise they are updated to be less aligned.
+// runs through each cluster and each stance and compares the stance with the stances from the candidate
+// updates it accordingly.
+// the candidates stances are held in issue id order so the stance for an issue is found by its id.
+// the rolls are drawn for as many clusters as fit in influenceBlockRolls then the clusters are moved on every issue
+// at once with influenceClusters.
+void Electorate::influenceElectorate(VoterStore& voters, Stance* candidateStances, bool positiveImpact, RandomGenerator& random){
+
+    int numOfIssues = voters.getNumOfIssues();
+    int clustersPerBlock = influenceBlockRolls / numOfIssues;
+    int8_t changes[influenceBlockRolls];
+    int16_t targets[MAX_ISSUES];
+
+    for(int issue = 0; issue < numOfIssues; issue++){
+        targets[issue] = candidateStances[issue].getApproach();
+    }
+
+    for(int first = firstCluster; first < firstCluster + numOfClusters; first += clustersPerBlock){
+        int count = std::min(clustersPerBlock, firstCluster + numOfClusters - first);
+        drawInfluenceRolls(random, count, numOfIssues, changes, count);
+        voters.influenceClusters(first, count, changes, count, targets, positiveImpact);
+    }
+
+}
+
+// function used to influence/update an individual stance of an electorate
+// random is the elections randomGenerator used to provide random stance range to update
+// between 1-3
+// if it is a positive impact the stance is updated to be more aligned with the stance provided,
+// otherwise it is updated to be less aligned.
+// the rolls of up to influenceRolls clusters are drawn at once.
+void Electorate::influenceStance(VoterStore& voters, Stance stance, bool positiveImpact, RandomGenerator& random){
+
+    int issue = stance.getIssueID();
+    int changes[influenceRolls];
+
+    for(int first = firstCluster; first < firstCluster + numOfClusters; first += influenceRolls){
+        int count = std::min(influenceRolls, firstCluster + numOfClusters - first);
+        random.randomIntRange(1, 3, changes, count);
+
+        for(int cluster = first; cluster < first + count; cluster++){
+            int change = changes[cluster - first];
+
+            if((voters.getApproach(cluster, issue) > stance.getApproach()) == positiveImpact) change *= -1;
+
+            voters.updateStance(cluster, issue, change);
+        }
+    }
+
+}
+
+// function used to apply stance changes recorded in an EventJournal to the electorate
+// the changes are in the order influenceElectorate (issue is -1) or influenceStance go through the clusters.
+// returns the number of changes used
+int Electorate::replayInfluence(VoterStore& voters, const int8_t* changes, int issue){
+
+    int used = 0;
+
+    for(int cluster = firstCluster; cluster < firstCluster + numOfClusters; cluster++){
+        if(issue == -1){
+            for(int clusterIssue = 0; clusterIssue < voters.getNumOfIssues(); clusterIssue++){
+                voters.updateStance(cluster, clusterIssue, changes[used++]);
+            }
+        }
+        else voters.updateStance(cluster, issue, changes[used++]);
+    }
+
+    return used;
+}
+
+/*  End of Electorate functions */
+
+
+/*  Start of VoterStore functions */
+// VoterStore constructor, changes aren't logged until a change log is set
+VoterStore::VoterStore(){
+    columns = make_shared<VoterColumns>();
+    changeLog = nullptr;
+    trackDirty = true;
+}
+
+// function used to set the vector every stance change is added to, nullptr stops logging
+void VoterStore::setChangeLog(vector<int8_t>* log){
+    changeLog = log;
+}
+
+// used to turn marking the clusters changed by updateStance on or off
+void VoterStore::setDirtyTracking(bool track){
+    trackDirty = track;
+}
+
+// used to copy the columns before they are changed if they are shared with the store of a fork
+void VoterStore::ownColumns(){
+    if(columns.use_count() > 1) columns = make_shared<VoterColumns>(*columns);
+}
+
+// function used to set up a stance array for each issue
+void VoterStore::setNumOfIssues(int numOfIssues){
+    ownColumns();
+    approach.resize(numOfIssues);
+    columns->significance.resize(numOfIssues);
+}
+
+// used to add a cluster to the store for the electorate provided
+// the stances of the new cluster start at 0 until they are set
+// returns the index of the new cluster
+int VoterStore::addCluster(int elecIndex, int64_t pop){
+
+    ownColumns();
+    columns->population.push_back(pop);
+    columns->electorate.push_back(elecIndex);
+    dirty.push_back(0);
+
+    for(unsigned int issue = 0; issue < approach.size(); issue++){
+        approach[issue].push_back(0);
+        columns->significance[issue].push_back(0);
+    }
+
+    return columns->population.size() - 1;
+}
+
+// used to add many clusters at once from tables laid out the same way as the store
+// approaches and significances hold the table of each issue
+void VoterStore::addClusters(int count, const int64_t* pop, const int32_t* elecIndexes, const int16_t* const* approaches, const int16_t* const* significances){
+
+    ownColumns();
+    columns->population.insert(columns->population.end(), pop, pop + count);
+    columns->electorate.insert(columns->electorate.end(), elecIndexes, elecIndexes + count);
+    dirty.resize(dirty.size() + count, 0);
+
+    for(unsigned int issue = 0; issue < approach.size(); issue++){
+        approach[issue].insert(approach[issue].end(), approaches[issue], approaches[issue] + count);
+        columns->significance[issue].insert(columns->significance[issue].end(), significances[issue], significances[issue] + count);
+    }
+}
+
+// used to reserve space for the number of clusters expected
+// so large scenarios don't keep reallocating while being generated
+void VoterStore::reserve(int numOfClusters){
+    ownColumns();
+    columns->population.reserve(numOfClusters);
+    columns->electorate.reserve(numOfClusters);
+    dirty.reserve(numOfClusters);
+
+    for(unsigned int issue = 0; issue < approach.size(); issue++){
+        approach[issue].reserve(numOfClusters);
+        columns->significance[issue].reserve(numOfClusters);
+    }
+}
+
+// used to mark a cluster as changed, it is only added to dirtyClusters the first time
+void VoterStore::markDirty(int cluster){
+    if(dirty[cluster]) return;
+    dirty[cluster] = 1;
+    dirtyClusters.push_back(cluster);
+}
+
+// used to clear the changed clusters once they have been looked at
+void VoterStore::clearDirty(){
+    for(int32_t cluster : dirtyClusters){
+        dirty[cluster] = 0;
+    }
+    dirtyClusters.clear();
+}
+
+vector<int32_t>& VoterStore::getDirtyClusters(){
+    return dirtyClusters;
+}
+
+// used to set the stance of a cluster for an issue
+void VoterStore::setStance(int cluster, int issue, int sig, int app){
+    ownColumns();
+    columns->significance[issue][cluster] = sig;
+    approach[issue][cluster] = app;
+}
+
+// used to update the approach of a cluster for an issue
+// ensures that it never goes under 0 or above 100
+void VoterStore::updateStance(int cluster, int issue, int stanceApp){
+
+    if(changeLog) changeLog->push_back(stanceApp);
+    if(trackDirty) markDirty(cluster);
+
+    int newStanceApp = approach[issue][cluster] + stanceApp;
+
+    if(newStanceApp > 100) approach[issue][cluster] = 100;
+    else if(newStanceApp < 0) approach[issue][cluster] = 0;
+    else approach[issue][cluster] = newStanceApp;
+}
+
+// function used to move count approaches towards the target approach for a positive impact or away from it otherwise
+// by the changes, keeping them between 0 and 100 like updateStance, starting from the first one that isn't done.
+static void influenceApproachesScalar(int16_t* approaches, int count, int done, const int8_t* changes, int target, bool positiveImpact){
+
+    for(int cluster = done; cluster < count; cluster++){
+        int change = changes[cluster];
+        if((approaches[cluster] > target) == positiveImpact) change = -change;
+
+        int newApproach = approaches[cluster] + change;
+        approaches[cluster] = newApproach > 100 ? 100 : (newApproach < 0 ? 0 : newApproach);
+    }
+}
+
+#ifdef ELECTION_VECTOR_KERNELS
+// AVX2 version of influenceApproachesScalar which does 16 approaches at once.
+// the lanes whose change is made negative are all ones in negate so the change is negated with an xor and subtract,
+// the new approaches are then kept between 0 and 100 with a min and max.
+// returns how many approaches it has done, the rest are done by the scalar version.
+__attribute__((target("avx2")))
+static int influenceApproachesAVX2(int16_t* approaches, int count, const int8_t* changes, int target, bool positiveImpact){
+
+    const __m256i targetApproach = _mm256_set1_epi16(target);
+    const __m256i flip = positiveImpact ? _mm256_setzero_si256() : _mm256_set1_epi16(-1);
+    const __m256i lowest = _mm256_setzero_si256();
+    const __m256i highest = _mm256_set1_epi16(100);
+
+    int cluster = 0;
+    for(; cluster + 16 <= count; cluster += 16){
+        __m256i approach = _mm256_loadu_si256((const __m256i*)(approaches + cluster));
+        __m256i change = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(changes + cluster)));
+
+        __m256i negate = _mm256_xor_si256(_mm256_cmpgt_epi16(approach, targetApproach), flip);
+        change = _mm256_sub_epi16(_mm256_xor_si256(change, negate), negate);
+
+        approach = _mm256_min_epi16(_mm256_max_epi16(_mm256_add_epi16(approach, change), lowest), highest);
+        _mm256_storeu_si256((__m256i*)(approaches + cluster), approach);
+    }
+
+    return cluster;
+}
+#endif
+
+// used to move the approaches of count clusters from first on every issue, like calling updateStance for each
+// changes holds how far each approach moves, the changes of an issue are stride apart, and targets the approach
+// of each issue they are moved towards for a positive impact or away from otherwise.
+// every issue is done in one pass over its approaches, with AVX2 when the cpu supports it.
+// the change log needs the changes cluster by cluster so they are made with updateStance when there is one.
+void VoterStore::influenceClusters(int first, int count, const int8_t* changes, int stride, const int16_t* targets, bool positiveImpact){
+
+    int numOfIssues = approach.size();
+
+    if(changeLog){
+        for(int cluster = 0; cluster < count; cluster++){
+            for(int issue = 0; issue < numOfIssues; issue++){
+                int change = changes[issue * stride + cluster];
+                if((approach[issue][first + cluster] > targets[issue]) == positiveImpact) change = -change;
+                updateStance(first + cluster, issue, change);
+            }
+        }
+        return;
+    }
+
+    if(trackDirty){
+        for(int cluster = first; cluster < first + count; cluster++){
+            markDirty(cluster);
+        }
+    }
+
+#ifdef ELECTION_VECTOR_KERNELS
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+
+    for(int issue = 0; issue < numOfIssues; issue++){
+        int16_t* approaches = approach[issue].data() + first;
+        const int8_t* issueChanges = changes + issue * stride;
+        int done = 0;
+
+#ifdef ELECTION_VECTOR_KERNELS
+        if(hasAVX2) done = influenceApproachesAVX2(approaches, count, issueChanges, targets[issue], positiveImpact);
+#endif
+
+        influenceApproachesScalar(approaches, count, done, issueChanges, targets[issue], positiveImpact);
+    }
+}
+
+// used to set the store up with the same clusters as the store of the election being forked
+// the columns that never change are shared with it and only the approaches and the dirty flags are made
+void VoterStore::shareClusters(VoterStore& source){
+    columns = source.columns;
+    approach = source.approach;
+    dirty.assign(source.dirty.size(), 0);
+    dirtyClusters.clear();
+}
+
+// used to copy the approach of every cluster out as [issue][cluster]
+void VoterStore::copyApproaches(int16_t* approaches){
+    int numOfClusters = getNumOfClusters();
+    for(unsigned int issue = 0; issue < approach.size(); issue++){
+        copy(approach[issue].begin(), approach[issue].end(), approaches + issue * numOfClusters);
+    }
+}
+
+// used to set the approach of every cluster from [issue][cluster], the clusters aren't marked dirty
+// so the projection has to be counted again from scratch afterwards
+void VoterStore::setApproaches(const int16_t* approaches){
+    int numOfClusters = getNumOfClusters();
+    for(unsigned int issue = 0; issue < approach.size(); issue++){
+        copy(approaches + issue * numOfClusters, approaches + (issue + 1) * numOfClusters, approach[issue].begin());
+    }
+}
+
+// used to print stances of a cluster, each stance is printed in the column of its issue
+void VoterStore::printStances(int cluster, IssueRegistry& issues){
+
+    for(unsigned int issue = 0; issue < approach.size(); issue++){
+        cout<<setw(issues.getColumnWidth(issue))<<to_string(columns->significance[issue][cluster]) + "/" + to_string(approach[issue][cluster]);
+    }
+    cout<<endl;
+}
+
+// below functions are getters for VoterStore
+int VoterStore::getNumOfClusters(){
+    return columns->population.size();
+}
+
+int VoterStore::getNumOfIssues(){
+    return approach.size();
+}
+
+int64_t VoterStore::getPopulation(int cluster){
+    return columns->population[cluster];
+}
+
+int VoterStore::getApproach(int cluster, int issue){
+    return approach[issue][cluster];
+}
+
+int VoterStore::getSignificance(int cluster, int issue){
+    return columns->significance[issue][cluster];
+}
+
+const int16_t* VoterStore::getApproaches(int issue){
+    return approach[issue].data();
+}
+
+const int16_t* VoterStore::getSignificances(int issue){
+    return columns->significance[issue].data();
+}
+
+const int32_t* VoterStore::getElectorates(){
+    return columns->electorate.data();
+}
+
+const int64_t* VoterStore::getPopulations(){
+    return columns->population.data();
+}
+/*  End of VoterStore functions */
+
+
+
+/*  Start of RandomGenerator functions */
+
+// RandomGenerator constructor
+// the seed is used as the Philox key and the run number is held in the last counter word
+// so every run of a batch gets different streams from the same seed.
+RandomGenerator::RandomGenerator(uint64_t seed, uint32_t runNumber){
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+    counter[0] = 0;
+    counter[3] = runNumber;
+    blockIndex = RANDOM_BUFFER_SIZE;
+    draws = 0;
+    setStream(RandomStream::GENERATION, 0, 0);
+}
+
+// function used to select the stream random numbers are drawn from
+// the counter holds {block number, electorate, day and stream, run number}
+// so each stream starts at block 0 and never overlaps with any other stream.
+// generation streams use the party index in place of the day.
+void RandomGenerator::setStream(RandomStream stream, uint32_t day, uint32_t electorate){
+    // the numbers drawn from the last stream are counted from its block number so drawing is never slowed down
+    STATS_ADD(draws, (uint64_t)counter[0] * 4 + blockIndex - RANDOM_BUFFER_SIZE);
+    counter[0] = 0;
+    counter[1] = electorate;
+    counter[2] = (day << 8) | static_cast<underlying_type<RandomStream>::type>(stream);
+    blockIndex = RANDOM_BUFFER_SIZE;
+    hasSpareNormal = false;
+}
+
+// function used to generate the block of 4 random numbers for a counter
+// runs the 10 rounds of Philox4x32 on the counter
+static void philoxBlock(const uint32_t* key, const uint32_t* counter, uint32_t* block){
+
+    const uint32_t multiplier0 = 0xD2511F53, multiplier1 = 0xCD9E8D57;
+    const uint32_t weyl0 = 0x9E3779B9, weyl1 = 0xBB67AE85;
+
+    uint32_t ctr[4] = {counter[0], counter[1], counter[2], counter[3]};
+    uint32_t roundKey[2] = {key[0], key[1]};
+
+    for(int round = 0; round < 10; round++){
+        uint64_t product0 = (uint64_t)multiplier0 * ctr[0];
+        uint64_t product1 = (uint64_t)multiplier1 * ctr[2];
+
+        uint32_t next[4];
+        next[0] = (uint32_t)(product1 >> 32) ^ ctr[1] ^ roundKey[0];
+        next[1] = (uint32_t)product1;
+        next[2] = (uint32_t)(product0 >> 32) ^ ctr[3] ^ roundKey[1];
+        next[3] = (uint32_t)product0;
+
+        for(int x = 0; x < 4; x++) ctr[x] = next[x];
+
+        roundKey[0] += weyl0;
+        roundKey[1] += weyl1;
+    }
+
+    for(int x = 0; x < 4; x++) block[x] = ctr[x];
+}
+
+#ifdef ELECTION_VECTOR_KERNELS
+// AVX2 version of philoxBlock which makes the 4 blocks from the counter onwards at once.
+// each word of the counter is held in the low half of the 64 bit lanes, one lane for each block,
+// so the 32 bit multiplies of Philox give their full 64 bit products.
+__attribute__((target("avx2")))
+static void philoxBlocksAVX2(const uint32_t* key, const uint32_t* counter, uint32_t* blocks){
+
+    const __m256i multiplier0 = _mm256_set1_epi64x(0xD2511F53);
+    const __m256i multiplier1 = _mm256_set1_epi64x(0xCD9E8D57);
+    const __m256i lowHalf = _mm256_set1_epi64x(0xFFFFFFFF);
+    const uint32_t weyl0 = 0x9E3779B9, weyl1 = 0xBB67AE85;
+
+    __m256i ctr0 = _mm256_setr_epi64x(counter[0], (uint32_t)(counter[0] + 1), (uint32_t)(counter[0] + 2), (uint32_t)(counter[0] + 3));
+    __m256i ctr1 = _mm256_set1_epi64x(counter[1]);
+    __m256i ctr2 = _mm256_set1_epi64x(counter[2]);
+    __m256i ctr3 = _mm256_set1_epi64x(counter[3]);
+    uint32_t roundKey[2] = {key[0], key[1]};
+
+    for(int round = 0; round < 10; round++){
+        __m256i product0 = _mm256_mul_epu32(ctr0, multiplier0);
+        __m256i product1 = _mm256_mul_epu32(ctr2, multiplier1);
+
+        ctr0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product1, 32), ctr1), _mm256_set1_epi64x(roundKey[0]));
+        ctr1 = _mm256_and_si256(product1, lowHalf);
+        ctr2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product0, 32), ctr3), _mm256_set1_epi64x(roundKey[1]));
+        ctr3 = _mm256_and_si256(product0, lowHalf);
+
+        roundKey[0] += weyl0;
+        roundKey[1] += weyl1;
+    }
+
+    // the words of each block are in the low halves of the same lane of each vector
+    alignas(32) uint64_t words[4][4];
+    _mm256_store_si256((__m256i*)words[0], ctr0);
+    _mm256_store_si256((__m256i*)words[1], ctr1);
+    _mm256_store_si256((__m256i*)words[2], ctr2);
+    _mm256_store_si256((__m256i*)words[3], ctr3);
+
+    for(int block = 0; block < 4; block++){
+        for(int word = 0; word < 4; word++) blocks[block * 4 + word] = (uint32_t)words[word][block];
+    }
+}
+#endif
+
+// function used to generate the next blocks of random numbers for the current stream
+// the first block of a stream is made on its own as most streams only use a few numbers,
+// after that RANDOM_BUFFER_BLOCKS blocks are made at once with AVX2 when the cpu supports it.
+// without AVX2 making more blocks at once isn't any faster so every block is made on its own at the end of the buffer.
+// the numbers are the same either way, the counter moves on by 1 for every block made.
+void RandomGenerator::nextBlocks(){
+
+#ifdef ELECTION_VECTOR_KERNELS
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+
+    if(hasAVX2 && counter[0] != 0 && RANDOM_BUFFER_BLOCKS == 4){
+        philoxBlocksAVX2(key, counter, block);
+        counter[0] += 4;
+        blockIndex = 0;
+        return;
+    }
+#endif
+
+    blockIndex = RANDOM_BUFFER_SIZE - 4;
+    philoxBlock(key, counter, block + blockIndex);
+    counter[0]++;
+}
+
+// function used to get the next random 32 bit number from the current stream
+uint32_t RandomGenerator::nextInt(){
+    if(blockIndex == RANDOM_BUFFER_SIZE) nextBlocks();
+    return block[blockIndex++];
+}
+
+// function used to get a random double in the range [0, 1) with 53 bits of precision
+double RandomGenerator::nextDouble(){
+    uint32_t high = nextInt() >> 5;
+    uint32_t low = nextInt() >> 6;
+    return (high * 67108864.0 + low) / 9007199254740992.0;
+}
+
+//function used to generate random int between range (inclusive)
+// uses a multiply and shift to map a 32 bit number onto the range
+// and rejects the few numbers that would make some results more likely than others.
+int RandomGenerator::randomIntRange(int min, int max){
+
+    uint32_t range = (uint32_t)(max - min) + 1;
+    uint64_t product = (uint64_t)nextInt() * range;
+    uint32_t low = (uint32_t)product;
+
+    if(low < range){
+        uint32_t threshold = (0u - range) % range;
+        while(low < threshold){
+            product = (uint64_t)nextInt() * range;
+            low = (uint32_t)product;
+        }
+    }
+
+    return min + (int)(product >> 32);
+}
+
+// 64 bit version of randomIntRange used for populations
+// a range that fits in 32 bits is rolled exactly like randomIntRange so it gives the same number,
+// a wider one is made from two numbers and rolled again until it is in the range.
+int64_t RandomGenerator::randomIntRange64(int64_t min, int64_t max){
+
+    uint64_t span = (uint64_t)max - (uint64_t)min;
+
+    if(span < UINT32_MAX){
+        uint32_t range = (uint32_t)span + 1;
+        uint64_t product = (uint64_t)nextInt() * range;
+        uint32_t low = (uint32_t)product;
+
+        if(low < range){
+            uint32_t threshold = (0u - range) % range;
+            while(low < threshold){
+                product = (uint64_t)nextInt() * range;
+                low = (uint32_t)product;
+            }
+        }
+
+        return min + (int64_t)(product >> 32);
+    }
+
+    // the smallest mask of low bits that covers the span
+    uint64_t mask = span;
+    for(int shift = 1; shift < 64; shift *= 2) mask |= mask >> shift;
+
+    uint64_t value;
+    do{
+        value = (((uint64_t)nextInt() << 32) | nextInt()) & mask;
+    } while(value > span);
+
+    return min + (int64_t)value;
+}
+
+// function used to fill values with count random ints between min and max (inclusive)
+// gives the same numbers as calling randomIntRange count times but takes them straight from the buffer,
+// only checking for the end of the buffer once for each run of numbers it holds.
+void RandomGenerator::randomIntRange(int min, int max, int* values, int count){
+
+    uint32_t range = (uint32_t)(max - min) + 1;
+    uint32_t threshold = (0u - range) % range;
+    int x = 0;
+
+    while(x < count){
+        if(blockIndex == RANDOM_BUFFER_SIZE) nextBlocks();
+        int end = std::min(count, x + RANDOM_BUFFER_SIZE - blockIndex);
+
+        while(x < end){
+            uint64_t product = (uint64_t)block[blockIndex++] * range;
+
+            // the few rejected numbers are drawn again with nextInt which can move on to the next blocks
+            if((uint32_t)product < threshold){
+                while((uint32_t)product < threshold) product = (uint64_t)nextInt() * range;
+                values[x++] = min + (int)(product >> 32);
+                break;
+            }
+
+            values[x++] = min + (int)(product >> 32);
+        }
+    }
+}
+
+// function used to pick 2 different numbers between 0 and count - 1 without replacement
+// the second is picked from the count - 1 numbers left and moved past the first,
+// so it always takes 2 rolls no matter how big count is.
+void RandomGenerator::randomPair(int count, int& first, int& second){
+    first = randomIntRange(0, count - 1);
+    second = randomIntRange(0, count - 2);
+    if(second >= first) second++;
+}
+
+// function used for standardDeviation
+int RandomGenerator::standardDeviation(int charvalue, int deviation){
+
+    int result;
+    result = round(charvalue + deviation * nextNormal());
+
+    return result;
+}
+
+// 64 bit version of standardDeviation used for populations and vote counts
+int64_t RandomGenerator::standardDeviation64(int64_t value, int64_t deviation){
+    return llround(value + deviation * nextNormal());
+}
+
+// returns the next normally distributed number with a mean of 0 and standard deviation of 1
+// uses the Box-Muller transform to turn 2 uniform numbers into 2 normally distributed numbers,
+// the second is kept for the next call.
+double RandomGenerator::nextNormal(){
+
+    if(hasSpareNormal){
+        hasSpareNormal = false;
+        return spareNormal;
+    }
+
+    double radius = sqrt(-2.0 * log(1.0 - nextDouble()));
+    double angle = 6.283185307179586 * nextDouble();
+    spareNormal = radius * sin(angle);
+    hasSpareNormal = true;
+
+    return radius * cos(angle);
+}
+
+// function used to move the generator onto the streams of another run of the same seed
+// a stream has to be selected again before the next roll.
+void RandomGenerator::setRun(uint32_t runNumber){
+    setStream(RandomStream::GENERATION, 0, 0);
+    counter[3] = runNumber;
+}
+
+// function used to get how many 32 bit numbers have been drawn from every stream of the generator
+uint64_t RandomGenerator::getNumOfDraws(){
+    return draws + (uint64_t)counter[0] * 4 + blockIndex - RANDOM_BUFFER_SIZE;
+}
+
+/*  End of RandomGenerator functions */
+
+
+/*  Start of Stance functions */
+//Stance constructor
+// takes the id of the issue in the IssueRegistry
+Stance::Stance(int issue, int sig, int app){
+    issueID = issue;
+    significance = sig;
+    approach = app;
+}
+
+// function used to get approach
+int Stance::getApproach(){
+    return this->approach;
+}
+
+// function used to set approach
+// ensures that it never goes under 0 or above 100
+void Stance::setApproach(int newStanceApp){
+    if(newStanceApp > 100) approach = 100;
+    else if(newStanceApp < 0) approach = 0;
+    else approach = newStanceApp;
+}
+
+// function used to get significance
+int Stance::getSignificance(){
+    return this->significance;
+}
+
+// function used to get the id of the Issue
+int Stance::getIssueID(){
+    return this->issueID;
+}
+
+
+/*  Start of Person functions */
+// Person constructor
+Person::Person(string pName){
+    name = make_shared<const string>(pName);
+    characteristicMask = 0;
+    fill(characteristics, characteristics + NUM_OF_CHARACTERISTICS, 0);
+}
+
+// Person default contructor
+// the person has no name until they are replaced or given one, getName returns an empty name for them
+Person::Person(){
+    characteristicMask = 0;
+    fill(characteristics, characteristics + NUM_OF_CHARACTERISTICS, 0);
+}
+
+// function used to give the person a Characteristic with a starting value
+void Person::setChar(Characteristic chr, unsigned int value){
+    int chrIndex = static_cast<underlying_type<Characteristic>::type>(chr);
+
+    characteristics[chrIndex] = value;
+    characteristicMask |= 1 << chrIndex;
+}
+
+// function used to check if the person has a Characteristic
+bool Person::hasChar(Characteristic chr){
+    return characteristicMask & (1 << static_cast<underlying_type<Characteristic>::type>(chr));
+}
+
+// function used to get value of a Characteristic of a person
+// returns 0 if the person doesn't have the Characteristic
+unsigned int Person::getCharValue(Characteristic chr){
+    return characteristics[static_cast<underlying_type<Characteristic>::type>(chr)];
+}
+
+// function used to upddate a Characteristic value
+// throws out_of_range if the person doesn't have the Characteristic
+void Person::updateChar(Characteristic chr, int value){
+
+    if(!hasChar(chr)) throw out_of_range("Person does not have the characteristic being updated");
+
+    unsigned int& charValue = characteristics[static_cast<underlying_type<Characteristic>::type>(chr)];
+    int updatedValue = charValue + value;
+
+    // ensures characteristic doesn't go higher than 100 or lower than 0
+    if(updatedValue > 100) charValue = 100;
+    else if(updatedValue < 0) charValue = 0;
+    else charValue += value;
+
+
+}
+
+// function used to print characteristics of a person
+// only the characteristics the person has are printed
+void Person::printCharacteristics(){
+
+    bool first = true;
+
+    for(int chrIndex = 0; chrIndex < NUM_OF_CHARACTERISTICS; chrIndex++){
+        Characteristic chr = static_cast<Characteristic>(chrIndex);
+        if(!hasChar(chr)) continue;
+
+        if(!first) cout<<", ";
+        cout<<chr<<": "<<characteristics[chrIndex];
+        first = false;
+    }
+
+}
+
+// below are getters/setters for Person
+void Person::setName(string newName){
+    name = make_shared<const string>(newName);
+}
+
+const string& Person::getName(){
+    static const string noName;
+    return name ? *name : noName;
+}
+
+/*  Start of Candidate functions */
+
+// Constructor specifically used to create leader candidate
+// Leaders characteristics will be random but at a higher range than other candidates
+// random is the elections generator used to return random num
+Candidate::Candidate(string lName, const vector<StanceRange>& sRanges, IssueRegistry& issues, RandomGenerator& random) : Person(lName){
+
+    // initialises votes/electorate and characteristics of leaders
+    totalVotes = 0;
+    clusterVotes = 0;
+    electorateID = -1;
+    setChar(Characteristic::POPULARITY, random.randomIntRange(25, 30));
+    setChar(Characteristic::CHARISMA, random.randomIntRange(25, 30));
+
+    // adds stances to leader, one for each issue in issue id order
+    shared_ptr<vector<Stance>> stanceList = make_shared<vector<Stance>>();
+    stanceList->reserve(issues.getNumOfIssues());
+    for(int issue = 0; issue < issues.getNumOfIssues(); issue++){
+        stanceList->push_back(Stance(issue, random.randomIntRange(sRanges[issue][0], sRanges[issue][1]), random.randomIntRange(sRanges[issue][2], sRanges[issue][3])));
+    }
+    stances = shared_ptr<Stance>(stanceList, stanceList->data());
+}
+
+//Constructor for all other candidates
+Candidate::Candidate(int elecID, string cName, const vector<StanceRange>& sRanges, IssueRegistry& issues, RandomGenerator& random) : Person(cName){
+
+    totalVotes = 0;
+    clusterVotes = 0;
+    electorateID = elecID;
+
+    setChar(Characteristic::POPULARITY, random.randomIntRange(10, 15));
+    setChar(Characteristic::CHARISMA, random.randomIntRange(10, 15));
+    setChar(Characteristic::DEBATING, random.randomIntRange(10, 15));
+
+    // adds a stance for each issue in issue id order
+    shared_ptr<vector<Stance>> stanceList = make_shared<vector<Stance>>();
+    stanceList->reserve(issues.getNumOfIssues());
+    for(int issue = 0; issue < issues.getNumOfIssues(); issue++){
+        stanceList->push_back(Stance(issue, random.randomIntRange(sRanges[issue][0], sRanges[issue][1]), random.randomIntRange(sRanges[issue][2], sRanges[issue][3])));
+    }
+    stances = shared_ptr<Stance>(stanceList, stanceList->data());
+}
+
+//Candidate default constructor
+Candidate::Candidate(){
+    totalVotes = 0;
+    clusterVotes = 0;
+    electorateID = -1;
+    relatedParty = nullptr;
+}
+
+//function used to print the stances of a candidate, each stance is printed in the column of its issue
+void Candidate::printStances(IssueRegistry& issues){
+
+    for(int issue = 0; issue < issues.getNumOfIssues(); issue++){
+        Stance& stance = stances.get()[issue];
+        cout<<setw(issues.getColumnWidth(stance.getIssueID()))<<to_string(stance.getSignificance()) + "/" + to_string(stance.getApproach());
+    }
+    cout<<endl;
+}
+
+// function used to calculate cluster votes based on stances won
+// stanceVotes based on the population of current cluster split between its issues
+// stancesWon is the number of the clusters stances the candidate was closest to
+void Candidate::calculateClusterVotes(int64_t stanceVotes, int stancesWon){
+    clusterVotes = stanceVotes * stancesWon;
+
+    updateTotalVotes(clusterVotes); // adds cluster votes to total votes
+}
+
+// function used to update the total votes of the candidate
+void Candidate::updateTotalVotes(int64_t votes){
+    totalVotes += votes;
+}
+
+// function used to set the total votes of the candidate when the election is restored
+void Candidate::setTotalVotes(int64_t votes){
+    totalVotes = votes;
+}
+
+
+// Below functions are setters/getters for candidate
+int64_t Candidate::getTotalVotes(){
+    return this->totalVotes;
+}
+
+int64_t Candidate::getClusterVotes(){
+    return this->clusterVotes;
+}
+
+
+int Candidate::getElectorateID(){
+    return this->electorateID;
+}
+
+// returns the stance of each issue in issue id order
+Stance* Candidate::getStances(){
+    return this->stances.get();
+}
+
+void Candidate::setRelatedParty(Party* party){
+    relatedParty = party;
+}
+
+Party* Candidate::getRelatedParty(){
+    return this->relatedParty;
+}
+
+/*  End of Candidate functions */
+
+/*  Start of CandidateTable functions */
+// CandidateTable constructor, the table starts empty
+CandidateTable::CandidateTable(){
+    numOfParties = 0;
+}
+
+// function used to set up a space for the candidate of every party in every electorate
+void CandidateTable::resize(int numOfElectorates, int parties){
+    numOfParties = parties;
+    candidates.resize(numOfElectorates * numOfParties);
+}
+
+// used to put a candidate into the table for the electorate and party given
+void CandidateTable::setCandidate(int elecID, int partyID, Candidate newCandidate){
+    candidates[elecID * numOfParties + partyID] = newCandidate;
+}
+
+// below functions are getters for CandidateTable
+Candidate& CandidateTable::getCandidate(int elecID, int partyID){
+    return candidates[elecID * numOfParties + partyID];
+}
+
+// returns the first candidate of the electorate, the candidate of each party follows in party order
+Candidate* CandidateTable::getElectorateCandidates(int elecID){
+    return &candidates[elecID * numOfParties];
+}
+
+int CandidateTable::getNumOfParties(){
+    return this->numOfParties;
+}
+
+int CandidateTable::getNumOfElectorates(){
+    if(numOfParties == 0) return 0;
+    return candidates.size() / numOfParties;
+}
+
+/*  End of CandidateTable functions */
+
+/*  Start of Party functions */
+// Party constructor
+// random is used to generate the managerial team for the party
+Party::Party(int partyID, string pName, string pDescription, Candidate lCandidate, const vector<StanceRange>& sRanges, RandomGenerator& random) : mngTeam(pName, random){
+    id = partyID;
+    name = pName;
+    description = pDescription;
+    leader = lCandidate;
+    electoratesWon = 0;
+    stanceRanges = make_shared<const vector<StanceRange>>(sRanges);
+}
+
+// function used to print party information
+// the candidates of the party are printed from the elections candidate table in electorate order
+void Party::printParty(CandidateTable& candidates, IssueRegistry& issues){
+    cout<<left<<setw(candidateLabelWidth)<<"Stances (Sig/App)"<<right;
+    issues.printIssueCodes();
+    cout<<"----------------------------------------------------------------------";
+    cout<<"-------------------------------------------"<<endl;
+    cout<<left<<setw(candidateLabelWidth)<<"Party(Ranges):"<<right;
+    for(unsigned int issue = 0; issue < stanceRanges->size(); issue++){
+        const StanceRange& range = (*stanceRanges)[issue];
+        cout<<setw(issues.getColumnWidth(issue))<<to_string(range[0]) + "-" + to_string(range[1]) + "/" + to_string(range[2]) + "-" + to_string(range[3]);
+    }
+    cout<<endl;
+
+    cout<<"Candidates "<<endl;
+
+    for(int elecID = 0; elecID < candidates.getNumOfElectorates(); elecID++){
+        Candidate& candidate = candidates.getCandidate(elecID, id);
+        cout<<left<<setw(candidateLabelWidth)<<candidate.getName() + ":"<<right;
+        candidate.printStances(issues);
+    }
+
+}
+
+// below functions are setters/getters for Party
+Candidate& Party::getLeader(){
+    return this->leader;
+}
+
+int Party::getID(){
+    return this->id;
+}
+
+const string& Party::getName(){
+    return this->name;
+}
+
+const string& Party::getDescription(){
+    return this->description;
+}
+
+ManagerialTeam& Party::getManagerialTeam(){
+    return this->mngTeam;
+}
+
+// used to increment electoratesWon
+void Party::updateElectoratesWon(){
+    electoratesWon++;
+}
+
+// used to set electoratesWon when the election is restored
+void Party::setElectoratesWon(int won){
+    electoratesWon = won;
+}
+
+int Party::getElectoratesWon(){
+    return this->electoratesWon;
+}
+
+/*  End of Party functions */
+
+
+/*  Start of ManagerialTeam functions */
+// constructer for ManagerialTeam
+ManagerialTeam::ManagerialTeam(string mname, RandomGenerator& random){
+
+    setName(mname + " Managerial Team");
+    setChar(Characteristic::EVENTHANDLE, random.randomIntRange(1,5));
+}
+// default constructor for ManagerialTeam
+ManagerialTeam::ManagerialTeam(){
+
+     setChar(Characteristic::EVENTHANDLE, 0);
+}
+
+/*  End of ManagerialTeam functions */
+
+
+/*  Start of EventCatalog functions */
+// the most points of weight a catalog can have, each point is one entry of the event table
+const int maxTotalWeight = 1000000;
+
+// function used to read the name of a characteristic used in the event file
+// "impact" is the impacted characteristic of the event
+static bool parseCharacteristic(const string& name, Event& event, Characteristic& chr){
+    if(name == "impact" && event.impactRange >= 0) chr = event.impactChar;
+    else if(name == "popularity") chr = Characteristic::POPULARITY;
+    else if(name == "charisma") chr = Characteristic::CHARISMA;
+    else if(name == "eventhandle") chr = Characteristic::EVENTHANDLE;
+    else if(name == "debating") chr = Characteristic::DEBATING;
+    else return false;
+    return true;
+}
+
+// function used to read a participant or stance source used in the event file
+static bool parseTarget(const string& name, EventTarget& target){
+    if(name == "first") target = EventTarget::FIRST;
+    else if(name == "second") target = EventTarget::SECOND;
+    else if(name == "winner") target = EventTarget::WINNER;
+    else if(name == "loser") target = EventTarget::LOSER;
+    else if(name == "random") target = EventTarget::RANDOM;
+    else return false;
+    return true;
+}
+
+// function used to read a whole number used in the event file, returns false if it isn't one
+static bool parseNumber(const string& number, int& value){
+    try{
+        size_t used;
+        value = stoi(number, &used);
+        return used == number.size();
+    }
+    catch(const exception&){
+        return false;
+    }
+}
+
+// function used to read the mean of a roll eg. impact+charisma/2+handle
+static bool parseRollMean(const string& mean, Event& event){
+
+    stringstream meanStream(mean);
+    string term;
+
+    event.numOfMeanTerms = 0;
+
+    while(getline(meanStream, term, '+')){
+        if(event.numOfMeanTerms == MAX_ROLL_TERMS) return false;
+
+        RollTerm& rollTerm = event.meanTerms[event.numOfMeanTerms++];
+        rollTerm = RollTerm();
+        rollTerm.divisor = 1;
+
+        if(term == "handle"){
+            rollTerm.handle = true;
+            continue;
+        }
+
+        size_t divide = term.find('/');
+        int divisor = 1;
+        if(divide != string::npos && (!parseNumber(term.substr(divide + 1), divisor) || divisor < 1 || divisor > 255)) return false;
+        if(!parseCharacteristic(term.substr(0, divide), event, rollTerm.characteristic)) return false;
+        rollTerm.divisor = divisor;
+    }
+
+    return event.numOfMeanTerms > 0;
+}
+
+// function used to read the amount of a characteristic change eg. +range, -range+handle or +range/2
+static bool parseChangeAmount(const string& amount, EventChange& change){
+
+    size_t pos = 0;
+    change.rangeSign = 1;
+    change.rangeDivisor = 1;
+    change.handleSign = 0;
+
+    if(pos < amount.size() && (amount[pos] == '+' || amount[pos] == '-')){
+        if(amount[pos] == '-') change.rangeSign = -1;
+        pos++;
+    }
+
+    if(amount.compare(pos, 5, "range") != 0) return false;
+    pos += 5;
+
+    if(pos < amount.size() && amount[pos] == '/'){
+        size_t end = amount.find_first_of("+-", pos);
+        int divisor;
+        if(!parseNumber(amount.substr(pos + 1, end - pos - 1), divisor) || divisor < 1 || divisor > 255) return false;
+        change.rangeDivisor = divisor;
+        pos = end == string::npos ? amount.size() : end;
+    }
+
+    string handle = amount.substr(pos);
+    if(handle == "+handle") change.handleSign = 1;
+    else if(handle == "-handle") change.handleSign = -1;
+    else if(!handle.empty()) return false;
+
+    return true;
+}
+
+// function used to check if a participant is known when the statement (outcome -1) or an outcome of an event is run
+// the winner is only known when the event succeeds and the loser only when a contest is won.
+static bool isTargetKnown(Event& event, int outcome, EventTarget target){
+    switch(target){
+        case EventTarget::FIRST: return event.participants != EventParticipants::NONE;
+        case EventTarget::SECOND: return event.participants == EventParticipants::CANDIDATES || event.participants == EventParticipants::LEADERS;
+        case EventTarget::WINNER: return outcome == 0 && event.participants != EventParticipants::NONE;
+        case EventTarget::LOSER: return outcome == 0 && event.roll == EventRoll::CONTEST;
+        default: return false;
+    }
+}
+
+// function used to check if the participants of an event hold a characteristic so it can be changed
+// candidates hold popularity, charisma and debating and leaders only popularity and charisma,
+// event handling belongs to the managerial teams. An event without participants changes no one.
+static bool isCharacteristicHeld(Event& event, Characteristic chr){
+    switch(event.participants){
+        case EventParticipants::CANDIDATE: case EventParticipants::CANDIDATES: return chr != Characteristic::EVENTHANDLE;
+        case EventParticipants::LEADERS: return chr == Characteristic::POPULARITY || chr == Characteristic::CHARISMA;
+        default: return true;
+    }
+}
+
+// function used to get the name of the participants of an event for an error
+static string participantsName(Event& event){
+    return event.participants == EventParticipants::LEADERS ? "leaders" : "candidates";
+}
+
+// function used to get the name of a characteristic as it is written in the event file
+static string characteristicName(Characteristic chr){
+    const char* names[NUM_OF_CHARACTERISTICS] = {"popularity", "charisma", "eventhandle", "debating"};
+    return names[static_cast<int>(chr)];
+}
+
+// function used to check if the values of a line of narration are known when it is narrated
+static bool isLineKnown(Event& event, int outcome, EventLine& line){
+    for(int x = 0; x < line.numOfArgs; x++){
+        switch(line.args[x]){
+            case EventText::FIRST: if(!isTargetKnown(event, outcome, EventTarget::FIRST)) return false; break;
+            case EventText::SECOND: if(!isTargetKnown(event, outcome, EventTarget::SECOND)) return false; break;
+            case EventText::WINNER: case EventText::PARTY: if(!isTargetKnown(event, outcome, EventTarget::WINNER)) return false; break;
+            case EventText::LOSER: if(!isTargetKnown(event, outcome, EventTarget::LOSER)) return false; break;
+            case EventText::ISSUE: if(!event.randomIssue) return false; break;
+            case EventText::ELECTORATE: break;
+        }
+    }
+    return true;
+}
+
+// function used to check an event once all of its directives have been read
+// makes sure the roll has the participants it needs and every value used by the event will be known.
+// returns false with the reason in error if it isn't valid
+static bool validateEvent(Event& event, string& error){
+
+    if(event.statement.text == 0){
+        error = "event has no statement";
+        return false;
+    }
+    if(event.roll == EventRoll::CONTEST && !isTargetKnown(event, -1, EventTarget::SECOND)){
+        error = "a contest needs two participants";
+        return false;
+    }
+    if(event.roll == EventRoll::CHECK && !isTargetKnown(event, -1, EventTarget::FIRST)){
+        error = "a check needs a participant";
+        return false;
+    }
+    if(event.roll == EventRoll::CHANCE && event.numOfSides < 1){
+        error = "event has no roll";
+        return false;
+    }
+    if(!isLineKnown(event, -1, event.statement)){
+        error = "the statement uses a value that isn't known before the roll";
+        return false;
+    }
+    if(event.impactRange >= 0 && !isCharacteristicHeld(event, event.impactChar)){
+        error = "impact " + characteristicName(event.impactChar) + " isn't held by " + participantsName(event);
+        return false;
+    }
+
+    for(int outcome = 0; outcome < 2; outcome++){
+        EventOutcome& eventOutcome = event.outcomes[outcome];
+        const string outcomeName = outcome == 0 ? "success" : "failure";
+
+        for(int x = 0; x < eventOutcome.numOfLines; x++){
+            if(!isLineKnown(event, outcome, eventOutcome.lines[x])){
+                error = outcomeName + " narration uses a value that isn't known";
+                return false;
+            }
+        }
+        for(int x = 0; x < eventOutcome.numOfChanges; x++){
+            if(!isTargetKnown(event, outcome, eventOutcome.changes[x].target)){
+                error = outcomeName + " changes a participant that isn't known";
+                return false;
+            }
+            if(!isCharacteristicHeld(event, eventOutcome.changes[x].characteristic)){
+                error = outcomeName + " changes " + characteristicName(eventOutcome.changes[x].characteristic) + " which isn't held by " + participantsName(event);
+                return false;
+            }
+        }
+        if(eventOutcome.influence == EventInfluence::NONE) continue;
+        if(eventOutcome.source == EventTarget::RANDOM ? eventOutcome.influence != EventInfluence::STANCE : !isTargetKnown(event, outcome, eventOutcome.source)){
+            error = outcomeName + " influences with stances that aren't known";
+            return false;
+        }
+        if(eventOutcome.influence == EventInfluence::STANCE && !event.randomIssue){
+            error = outcomeName + " influences a stance but the event has no issue";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// function used to load the event catalog from an event file
+// each event starts with an "event <name>" line followed by its directives, see Events.txt for the format.
+// every event is compiled into a flat dispatch record and the event table is built from the weights.
+void EventCatalog::load(const string& fileName){
+
+    ifstream eventFile;
+    string line, error;
+    int lineNumber = 0;
+
+    eventFile.open(fileName);
+
+    if(eventFile.bad() || !eventFile.is_open()){
+        cerr<<"Event file "<<fileName<<" was unable to be opened"<<endl;
+        exit(1);
+    }
+
+    events.clear();
+    text.assign(1, '\0'); // offset 0 is kept for text that hasn't been set
+
+    while(error.empty() && getline(eventFile, line)){
+        lineNumber++;
+
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+        if(line.empty() || line[0] == '#') continue;
+
+        if(line.compare(0, 6, "event ") == 0){
+            if(!events.empty() && !validateEvent(events.back(), error)){
+                error = string(getText(events.back().name)) + ": " + error;
+                break;
+            }
+            if(events.size() == UINT16_MAX){
+                error = "too many events";
+                break;
+            }
+
+            Event event = Event();
+            event.name = addText(line.substr(6));
+            event.code = events.size();
+            event.type = EventType::DEBATE;
+            event.weight = 1;
+            event.impactRange = -1; // set by the impact directive
+            events.push_back(event);
+        }
+        else if(events.empty()) error = "directive before the first event";
+        else parseDirective(events.back(), line, error);
+    }
+
+    if(error.empty() && events.empty()) error = "no events";
+    if(error.empty() && !validateEvent(events.back(), error)) error = string(getText(events.back().name)) + ": " + error;
+
+    if(!error.empty()){
+        cerr<<"Event file "<<fileName<<" line "<<lineNumber<<": "<<error<<endl;
+        exit(1);
+    }
+
+    int totalWeight = 0;
+    for(Event& event : events){
+        if(event.impactRange < 0) event.impactRange = 0;
+        totalWeight += event.weight;
+        if(totalWeight > maxTotalWeight){
+            cerr<<"Event file "<<fileName<<": the total weight of the events is over "<<maxTotalWeight<<endl;
+            exit(1);
+        }
+    }
+
+    if(totalWeight == 0){
+        cerr<<"Event file "<<fileName<<": the total weight of the events is 0"<<endl;
+        exit(1);
+    }
+
+    // builds the alias tables for before and after a leader event has happened in a day
+    buildAliasTable(aliasTables[0], true);
+    buildAliasTable(aliasTables[1], false);
+
+    eventFile.close();
+}
+
+// function used to read one directive of an event and compile it into the event
+// returns false with the reason in error if the directive isn't valid
+bool EventCatalog::parseDirective(Event& event, const string& line, string& error){
+
+    stringstream lineStream(line);
+    string directive, value;
+    lineStream>>directive;
+
+    if(directive == "statement"){
+        return compileLine(line.substr(min(line.size(), directive.size() + 1)), event.statement, error);
+    }
+    else if(directive == "type"){
+        lineStream>>value;
+        if(value == "debate") event.type = EventType::DEBATE;
+        else if(value == "candidate") event.type = EventType::CANDIDATE_RELATED;
+        else if(value == "leader") event.type = EventType::LEADER_RELATED;
+        else if(value == "issue") event.type = EventType::ISSUE_RELATED;
+        else error = "unknown event type " + value;
+    }
+    else if(directive == "weight"){
+        lineStream>>value;
+        if(!parseNumber(value, event.weight) || event.weight < 0 || event.weight > maxTotalWeight) error = "invalid weight " + value;
+    }
+    else if(directive == "participants"){
+        lineStream>>value;
+        if(value == "none") event.participants = EventParticipants::NONE;
+        else if(value == "candidate") event.participants = EventParticipants::CANDIDATE;
+        else if(value == "candidates") event.participants = EventParticipants::CANDIDATES;
+        else if(value == "leaders") event.participants = EventParticipants::LEADERS;
+        else error = "unknown participants " + value;
+    }
+    else if(directive == "issue"){
+        lineStream>>value;
+        if(value == "random") event.randomIssue = true;
+        else error = "unknown issue " + value;
+    }
+    else if(directive == "impact"){
+        string range;
+        lineStream>>value>>range;
+        if(value == "impact" || !parseCharacteristic(value, event, event.impactChar)) error = "unknown characteristic " + value;
+        else if(!parseNumber(range, event.impactRange) || event.impactRange < 0 || event.impactRange > 100) error = "invalid impact range " + range;
+    }
+    else if(directive == "roll"){
+        string mean, deviation, pass, bonus;
+        lineStream>>value;
+
+        if(value == "contest" || value == "check"){
+            lineStream>>mean>>deviation>>pass>>bonus;
+            event.roll = value == "contest" ? EventRoll::CONTEST : EventRoll::CHECK;
+            event.handleBonus = bonus == "handle";
+            if(!parseRollMean(mean, event)) error = "invalid roll mean " + mean;
+            else if(!parseNumber(deviation, event.deviation) || event.deviation < 0) error = "invalid roll deviation " + deviation;
+            else if(event.roll == EventRoll::CHECK && !parseNumber(pass, event.passRoll)) error = "invalid pass roll " + pass;
+            else if(event.roll == EventRoll::CONTEST && !pass.empty()) error = "a contest has no pass roll";
+            else if(!bonus.empty() && bonus != "handle") error = "unknown roll bonus " + bonus;
+        }
+        else if(value == "chance"){
+            string sides;
+            lineStream>>sides>>pass;
+            event.roll = EventRoll::CHANCE;
+            if(!parseNumber(sides, event.numOfSides) || event.numOfSides < 1) error = "invalid number of sides " + sides;
+            else if(!parseNumber(pass, event.passRoll)) error = "invalid pass roll " + pass;
+        }
+        else error = "unknown roll " + value;
+    }
+    else if(directive == "success" || directive == "failure"){
+        EventOutcome& outcome = event.outcomes[directive == "success" ? 0 : 1];
+        string action;
+        lineStream>>action;
+
+        if(action == "say"){
+            if(outcome.numOfLines == MAX_EVENT_LINES) error = "too many lines for " + directive;
+            else{
+                size_t textStart = line.find("say") + 3;
+                if(textStart < line.size()) textStart++;
+                return compileLine(line.substr(textStart), outcome.lines[outcome.numOfLines++], error);
+            }
+        }
+        else if(action == "change"){
+            string target, chr, amount;
+            lineStream>>target>>chr>>amount;
+            if(outcome.numOfChanges == MAX_EVENT_CHANGES) error = "too many changes for " + directive;
+            else{
+                EventChange& change = outcome.changes[outcome.numOfChanges++];
+                if(!parseTarget(target, change.target) || change.target == EventTarget::RANDOM) error = "unknown participant " + target;
+                else if(!parseCharacteristic(chr, event, change.characteristic)) error = "unknown characteristic " + chr + " (impact has to come first)";
+                else if(!parseChangeAmount(amount, change)) error = "invalid amount " + amount;
+            }
+        }
+        else if(action == "influence"){
+            string influence, source, direction;
+            lineStream>>influence>>source>>direction;
+            if(influence == "electorate") outcome.influence = EventInfluence::ELECTORATE;
+            else if(influence == "national") outcome.influence = EventInfluence::NATIONAL;
+            else if(influence == "stance") outcome.influence = EventInfluence::STANCE;
+            else error = "unknown influence " + influence;
+
+            if(error.empty() && !parseTarget(source, outcome.source)) error = "unknown stance source " + source;
+            else if(error.empty() && direction != "positive" && direction != "negative") error = "unknown direction " + direction;
+            outcome.positive = direction == "positive";
+        }
+        else error = "unknown action " + action;
+    }
+    else error = "unknown directive " + directive;
+
+    return error.empty();
+}
+
+// function used to compile a line of narration from the event file into an EventLine
+// each {value} is replaced with %s and added to the args of the line, % is escaped and a new line is added to the end.
+bool EventCatalog::compileLine(const string& lineText, EventLine& line, string& error){
+
+    string format;
+    line.numOfArgs = 0;
+
+    for(size_t x = 0; x < lineText.size(); x++){
+        if(lineText[x] == '%'){
+            format += "%%";
+            continue;
+        }
+        if(lineText[x] != '{'){
+            format += lineText[x];
+            continue;
+        }
+
+        size_t end = lineText.find('}', x);
+        string name = lineText.substr(x + 1, end == string::npos ? string::npos : end - x - 1);
+        EventText arg;
+
+        if(name == "first") arg = EventText::FIRST;
+        else if(name == "second") arg = EventText::SECOND;
+        else if(name == "winner") arg = EventText::WINNER;
+        else if(name == "loser") arg = EventText::LOSER;
+        else if(name == "party") arg = EventText::PARTY;
+        else if(name == "electorate") arg = EventText::ELECTORATE;
+        else if(name == "issue") arg = EventText::ISSUE;
+        else{
+            error = "unknown value {" + name + "}";
+            return false;
+        }
+
+        if(line.numOfArgs == MAX_EVENT_TEXT_ARGS){
+            error = "too many values in one line";
+            return false;
+        }
+
+        line.args[line.numOfArgs++] = arg;
+        format += "%s";
+        x = end;
+    }
+
+    line.text = addText(format + "\n");
+
+    return true;
+}
+
+// function used to build the alias table of the events that can be picked, leader events are left out unless includeLeader is true
+// Vose's alias method is used with whole numbers so the chance of each event is exactly its weight out of the total weight.
+// each weight is scaled by the number of columns so a full column is worth the total weight,
+// columns under the total weight are filled in with part of a column over it which becomes their alias.
+void EventCatalog::buildAliasTable(AliasTable& table, bool includeLeader){
+
+    vector<int64_t> scaledWeights;
+    vector<int> small, large;
+
+    table.totalWeight = 0;
+    table.codes.clear();
+
+    for(Event& event : events){
+        if(event.weight == 0 || (!includeLeader && event.type == EventType::LEADER_RELATED)) continue;
+        table.codes.push_back(event.code);
+        table.totalWeight += event.weight;
+    }
+
+    int numOfColumns = table.codes.size();
+    table.aliases = table.codes; // columns which are never topped up are full and never use their alias
+    table.thresholds.assign(numOfColumns, table.totalWeight);
+
+    for(int column = 0; column < numOfColumns; column++){
+        scaledWeights.push_back((int64_t)events[table.codes[column]].weight * numOfColumns);
+        if(scaledWeights[column] < table.totalWeight) small.push_back(column);
+        else large.push_back(column);
+    }
+
+    // each small column is topped up from a large column, which can then become small itself
+    while(!small.empty() && !large.empty()){
+        int smallColumn = small.back();
+        int largeColumn = large.back();
+        small.pop_back();
+
+        table.thresholds[smallColumn] = scaledWeights[smallColumn];
+        table.aliases[smallColumn] = table.codes[largeColumn];
+        scaledWeights[largeColumn] -= table.totalWeight - scaledWeights[smallColumn];
+
+        if(scaledWeights[largeColumn] < table.totalWeight){
+            large.pop_back();
+            small.push_back(largeColumn);
+        }
+    }
+}
+
+// function used to pick an event by weight, leaderEventUsed picks from the table without leader events
+// takes one roll for the column and one for the point of the weight.
+// returns -1 if there are no events that can be picked
+int EventCatalog::pickEvent(RandomGenerator& random, bool leaderEventUsed){
+
+    AliasTable& table = aliasTables[leaderEventUsed ? 1 : 0];
+
+    if(table.codes.empty()) return -1;
+
+    int column = random.randomIntRange(0, table.codes.size() - 1);
+    int point = random.randomIntRange(0, table.totalWeight - 1);
+
+    return point < table.thresholds[column] ? table.codes[column] : table.aliases[column];
+}
+
+// function used to add text to the end of the catalog text, returns its offset
+uint32_t EventCatalog::addText(const string& newText){
+    uint32_t offset = text.size();
+    text += newText;
+    text += '\0';
+    return offset;
+}
+
+// below getters for EventCatalog
+Event& EventCatalog::operator[](int code){
+    return events[code];
+}
+
+int EventCatalog::getNumOfEvents(){
+    return events.size();
+}
+
+const char* EventCatalog::getText(uint32_t offset){
+    return text.c_str() + offset;
+}
+
+/*  End of EventCatalog functions */
+
+
+/*  Start of vote tally kernel functions */
+
+// the most parties the vector versions of the kernel keep win counts for,
+// elections with more parties use the plain loop version.
+const int maxVectorParties = 64;
+
+// every version of the kernel is a template on the number of issues, fixedIssues is 0 for the version
+// that reads the number of issues from the CandidateMatrix. The common numbers of issues have their own
+// versions so the issue loops have a fixed length the compiler can unroll.
+
+// plain loop version of countStancesWon, also used for the clusters left over by the vector versions.
+// runs from the lane "from" (cluster firstCluster + from) to the end of the block.
+// for each issue the candidate with the lowest range wins the stance, the range is the
+// approach and significance ranges added together less 1/4 of the candidates popularity.
+// if ranges are equal the first candidate keeps the stance.
+template<int fixedIssues>
+static void countStancesWonScalar(VoterStore& voters, CandidateMatrix& candidates, int firstCluster, int count, int from, uint8_t* stancesWon){
+
+    int numOfParties = candidates.numOfParties;
+    const int numOfIssues = fixedIssues ? fixedIssues : candidates.numOfIssues;
+    const int32_t* clusterElectorate = voters.getElectorates();
+
+    for(int lane = from; lane < count; lane++){
+        int cluster = firstCluster + lane;
+        int candidateBase = clusterElectorate[cluster] * numOfParties;
+
+        for(int party = 0; party < numOfParties; party++){
+            stancesWon[party * count + lane] = 0;
+        }
+
+        for(int issue = 0; issue < numOfIssues; issue++){
+            int clusterApp = voters.getApproaches(issue)[cluster];
+            int clusterSig = voters.getSignificances(issue)[cluster];
+            int previousRange = 999999;
+            int stanceWinner = 0;
+
+            for(int party = 0; party < numOfParties; party++){
+                int candidateIndex = candidateBase + party;
+                int appRange = getRange(candidates.approach[candidateIndex * numOfIssues + issue], clusterApp);
+                int sigRange = getRange(candidates.significance[candidateIndex * numOfIssues + issue], clusterSig);
+
+                int totalRange = appRange + sigRange - candidates.popularityBonus[candidateIndex];
+
+                if(totalRange < previousRange){
+                    previousRange = totalRange;
+                    stanceWinner = party;
+                }
+            }
+
+            stancesWon[stanceWinner * count + lane]++;
+        }
+    }
+}
+
+#ifdef ELECTION_VECTOR_KERNELS
+
+// AVX2 version of countStancesWon which works on 8 clusters at once.
+// candidate values are gathered for each lane using the electorate of the cluster,
+// the indexes are relative to the first electorate of the block so they stay small.
+// returns how many clusters of the block it has done.
+template<int fixedIssues>
+__attribute__((target("avx2")))
+static int countStancesWonAVX2(VoterStore& voters, CandidateMatrix& candidates, int firstCluster, int count, uint8_t* stancesWon){
+
+    const int lanes = 8;
+    int numOfParties = candidates.numOfParties;
+    const int numOfIssues = fixedIssues ? fixedIssues : candidates.numOfIssues;
+    int done = count - (count % lanes);
+    const int32_t* clusterElectorate = voters.getElectorates();
+    int firstElectorate = clusterElectorate[firstCluster];
+
+    const int* approachBase = candidates.approach.data() + firstElectorate * numOfParties * numOfIssues;
+    const int* significanceBase = candidates.significance.data() + firstElectorate * numOfParties * numOfIssues;
+    const int* bonusBase = candidates.popularityBonus.data() + firstElectorate * numOfParties;
+
+    __m256i bonus[maxVectorParties];
+    __m256i wins[maxVectorParties];
+    alignas(32) int32_t laneWins[lanes];
+
+    for(int lane = 0; lane < done; lane += lanes){
+        int cluster = firstCluster + lane;
+
+        __m256i electorate = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(clusterElectorate + cluster)), _mm256_set1_epi32(firstElectorate));
+        __m256i candidateBase = _mm256_mullo_epi32(electorate, _mm256_set1_epi32(numOfParties));
+        __m256i stanceBase = _mm256_mullo_epi32(candidateBase, _mm256_set1_epi32(numOfIssues));
+
+        for(int party = 0; party < numOfParties; party++){
+            bonus[party] = _mm256_i32gather_epi32(bonusBase, _mm256_add_epi32(candidateBase, _mm256_set1_epi32(party)), 4);
+            wins[party] = _mm256_setzero_si256();
+        }
+
+        for(int issue = 0; issue < numOfIssues; issue++){
+            __m256i clusterApp = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(voters.getApproaches(issue) + cluster)));
+            __m256i clusterSig = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(voters.getSignificances(issue) + cluster)));
+            __m256i previousRange = _mm256_set1_epi32(999999);
+            __m256i stanceWinner = _mm256_setzero_si256();
+
+            for(int party = 0; party < numOfParties; party++){
+                __m256i stanceIndex = _mm256_add_epi32(stanceBase, _mm256_set1_epi32(party * numOfIssues + issue));
+                __m256i candidateApp = _mm256_i32gather_epi32(approachBase, stanceIndex, 4);
+                __m256i candidateSig = _mm256_i32gather_epi32(significanceBase, stanceIndex, 4);
+
+                __m256i totalRange = _mm256_add_epi32(_mm256_abs_epi32(_mm256_sub_epi32(candidateApp, clusterApp)),
+                                                      _mm256_abs_epi32(_mm256_sub_epi32(candidateSig, clusterSig)));
+                totalRange = _mm256_sub_epi32(totalRange, bonus[party]);
+
+                __m256i closer = _mm256_cmpgt_epi32(previousRange, totalRange);
+                previousRange = _mm256_blendv_epi8(previousRange, totalRange, closer);
+                stanceWinner = _mm256_blendv_epi8(stanceWinner, _mm256_set1_epi32(party), closer);
+            }
+
+            // cmpeq gives -1 for each lane the party won so subtracting adds 1
+            for(int party = 0; party < numOfParties; party++){
+                wins[party] = _mm256_sub_epi32(wins[party], _mm256_cmpeq_epi32(stanceWinner, _mm256_set1_epi32(party)));
+            }
+        }
+
+        for(int party = 0; party < numOfParties; party++){
+            _mm256_store_si256((__m256i*)laneWins, wins[party]);
+            for(int x = 0; x < lanes; x++){
+                stancesWon[party * count + lane + x] = laneWins[x];
+            }
+        }
+    }
+
+    return done;
+}
+
+// AVX2 version of countStancesWon for the fixed numbers of issues which works on one cluster at a time
+// with the issues across the vector. The stances of a candidate are next to each other in the CandidateMatrix
+// so they are loaded without a gather, the stances of the cluster are loaded from the VoterStore once and
+// used for every party. When the issues don't fill the last vector the rest of it is masked off.
+// returns how many clusters of the block it has done, which is all of them.
+template<int fixedIssues>
+__attribute__((target("avx2,popcnt")))
+static int countStancesWonIssuesAVX2(VoterStore& voters, CandidateMatrix& candidates, int firstCluster, int count, uint8_t* stancesWon){
+
+    const int lanes = 8;
+    const int vectors = (fixedIssues + lanes - 1) / lanes;
+    const int lastLanes = fixedIssues - (vectors - 1) * lanes;
+    int numOfParties = candidates.numOfParties;
+    const int32_t* clusterElectorate = voters.getElectorates();
+    const int32_t* approach = candidates.approach.data();
+    const int32_t* significance = candidates.significance.data();
+
+    // the lanes past the last issue load the first issue again, the stances they win are never counted
+    const int16_t* clusterApproaches[vectors * lanes];
+    const int16_t* clusterSignificances[vectors * lanes];
+    for(int issue = 0; issue < vectors * lanes; issue++){
+        clusterApproaches[issue] = voters.getApproaches(issue < fixedIssues ? issue : 0);
+        clusterSignificances[issue] = voters.getSignificances(issue < fixedIssues ? issue : 0);
+    }
+
+    // the lanes of the last vector that have an issue, the candidate stances past the last issue are never loaded
+    __m256i lastMask = _mm256_cmpgt_epi32(_mm256_set1_epi32(lastLanes), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    int lastBits = (1 << lastLanes) - 1;
+
+    for(int lane = 0; lane < count; lane++){
+        int cluster = firstCluster + lane;
+        int candidateBase = clusterElectorate[cluster] * numOfParties;
+
+        __m256i clusterApp[vectors];
+        __m256i clusterSig[vectors];
+        __m256i previousRange[vectors];
+        __m256i stanceWinner[vectors];
+        for(int vector = 0; vector < vectors; vector++){
+            const int16_t* const* app = clusterApproaches + vector * lanes;
+            const int16_t* const* sig = clusterSignificances + vector * lanes;
+            clusterApp[vector] = _mm256_setr_epi32(app[0][cluster], app[1][cluster], app[2][cluster], app[3][cluster],
+                                                   app[4][cluster], app[5][cluster], app[6][cluster], app[7][cluster]);
+            clusterSig[vector] = _mm256_setr_epi32(sig[0][cluster], sig[1][cluster], sig[2][cluster], sig[3][cluster],
+                                                   sig[4][cluster], sig[5][cluster], sig[6][cluster], sig[7][cluster]);
+            previousRange[vector] = _mm256_set1_epi32(999999);
+            stanceWinner[vector] = _mm256_setzero_si256();
+        }
+
+        for(int party = 0; party < numOfParties; party++){
+            int candidateIndex = candidateBase + party;
+            __m256i bonus = _mm256_set1_epi32(candidates.popularityBonus[candidateIndex]);
+            __m256i partyIndex = _mm256_set1_epi32(party);
+
+            for(int vector = 0; vector < vectors; vector++){
+                int stance = candidateIndex * fixedIssues + vector * lanes;
+                __m256i candidateApp, candidateSig;
+                if(vector == vectors - 1 && lastLanes != lanes){
+                    candidateApp = _mm256_maskload_epi32(approach + stance, lastMask);
+                    candidateSig = _mm256_maskload_epi32(significance + stance, lastMask);
+                }
+                else{
+                    candidateApp = _mm256_loadu_si256((const __m256i*)(approach + stance));
+                    candidateSig = _mm256_loadu_si256((const __m256i*)(significance + stance));
+                }
+
+                __m256i totalRange = _mm256_add_epi32(_mm256_abs_epi32(_mm256_sub_epi32(candidateApp, clusterApp[vector])),
+                                                      _mm256_abs_epi32(_mm256_sub_epi32(candidateSig, clusterSig[vector])));
+                totalRange = _mm256_sub_epi32(totalRange, bonus);
+
+                __m256i closer = _mm256_cmpgt_epi32(previousRange[vector], totalRange);
+                previousRange[vector] = _mm256_blendv_epi8(previousRange[vector], totalRange, closer);
+                stanceWinner[vector] = _mm256_blendv_epi8(stanceWinner[vector], partyIndex, closer);
+            }
+        }
+
+        // each issue the party won sets one bit of the mask
+        for(int party = 0; party < numOfParties; party++){
+            int wins = 0;
+            for(int vector = 0; vector < vectors; vector++){
+                __m256i won = _mm256_cmpeq_epi32(stanceWinner[vector], _mm256_set1_epi32(party));
+                int bits = _mm256_movemask_ps(_mm256_castsi256_ps(won));
+                if(vector == vectors - 1) bits &= lastBits;
+                wins += __builtin_popcount(bits);
+            }
+            stancesWon[party * count + lane] = wins;
+        }
+    }
+
+    return count;
+}
+
+// SSE2 version of countStancesWon which works on 4 clusters at once.
+// SSE2 has no gather, abs or blend so candidate values are loaded one lane at a time,
+// abs uses the sign mask and blends are done with and/andnot/or.
+// returns how many clusters of the block it has done.
+template<int fixedIssues>
+__attribute__((target("sse2")))
+static int countStancesWonSSE2(VoterStore& voters, CandidateMatrix& candidates, int firstCluster, int count, uint8_t* stancesWon){
+
+    const int lanes = 4;
+    int numOfParties = candidates.numOfParties;
+    const int numOfIssues = fixedIssues ? fixedIssues : candidates.numOfIssues;
+    int done = count - (count % lanes);
+    const int32_t* clusterElectorate = voters.getElectorates();
+    const int32_t* approach = candidates.approach.data();
+    const int32_t* significance = candidates.significance.data();
+    const int32_t* popularityBonus = candidates.popularityBonus.data();
+
+    __m128i bonus[maxVectorParties];
+    __m128i wins[maxVectorParties];
+    alignas(16) int32_t laneWins[lanes];
+    int candidateBase[lanes];
+
+    for(int lane = 0; lane < done; lane += lanes){
+        int cluster = firstCluster + lane;
+
+        for(int x = 0; x < lanes; x++){
+            candidateBase[x] = clusterElectorate[cluster + x] * numOfParties;
+        }
+
+        for(int party = 0; party < numOfParties; party++){
+            bonus[party] = _mm_set_epi32(popularityBonus[candidateBase[3] + party], popularityBonus[candidateBase[2] + party],
+                                         popularityBonus[candidateBase[1] + party], popularityBonus[candidateBase[0] + party]);
+            wins[party] = _mm_setzero_si128();
+        }
+
+        for(int issue = 0; issue < numOfIssues; issue++){
+            // stances are never negative so they can be widened to 32 bits by unpacking with zero
+            __m128i clusterApp = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(voters.getApproaches(issue) + cluster)), _mm_setzero_si128());
+            __m128i clusterSig = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(voters.getSignificances(issue) + cluster)), _mm_setzero_si128());
+            __m128i previousRange = _mm_set1_epi32(999999);
+            __m128i stanceWinner = _mm_setzero_si128();
+
+            for(int party = 0; party < numOfParties; party++){
+                int stance[lanes];
+                for(int x = 0; x < lanes; x++){
+                    stance[x] = (candidateBase[x] + party) * numOfIssues + issue;
+                }
+                __m128i candidateApp = _mm_set_epi32(approach[stance[3]], approach[stance[2]], approach[stance[1]], approach[stance[0]]);
+                __m128i candidateSig = _mm_set_epi32(significance[stance[3]], significance[stance[2]], significance[stance[1]], significance[stance[0]]);
+
+                __m128i appDiff = _mm_sub_epi32(candidateApp, clusterApp);
+                __m128i sigDiff = _mm_sub_epi32(candidateSig, clusterSig);
+                __m128i appSign = _mm_srai_epi32(appDiff, 31);
+                __m128i sigSign = _mm_srai_epi32(sigDiff, 31);
+
+                __m128i totalRange = _mm_add_epi32(_mm_sub_epi32(_mm_xor_si128(appDiff, appSign), appSign),
+                                                   _mm_sub_epi32(_mm_xor_si128(sigDiff, sigSign), sigSign));
+                totalRange = _mm_sub_epi32(totalRange, bonus[party]);
+
+                __m128i closer = _mm_cmpgt_epi32(previousRange, totalRange);
+                previousRange = _mm_or_si128(_mm_and_si128(closer, totalRange), _mm_andnot_si128(closer, previousRange));
+                stanceWinner = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(party)), _mm_andnot_si128(closer, stanceWinner));
+            }
+
+            for(int party = 0; party < numOfParties; party++){
+                wins[party] = _mm_sub_epi32(wins[party], _mm_cmpeq_epi32(stanceWinner, _mm_set1_epi32(party)));
+            }
+        }
+
+        for(int party = 0; party < numOfParties; party++){
+            _mm_store_si128((__m128i*)laneWins, wins[party]);
+            for(int x = 0; x < lanes; x++){
+                stancesWon[party * count + lane + x] = laneWins[x];
+            }
+        }
+    }
+
+    return done;
+}
+#endif
+
+// function used to count the stances won by each candidate for a block of clusters with fixedIssues issues
+// picks the widest version of the kernel the cpu supports, the clusters the vector
+// version can't fill a full vector with are done by the plain loop version.
+template<int fixedIssues>
+static void countStancesWonFor(VoterStore& voters, CandidateMatrix& candidates, int firstCluster, int count, uint8_t* stancesWon){
+
+    int done = 0;
+
+#ifdef ELECTION_VECTOR_KERNELS
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+    static const bool hasSSE2 = __builtin_cpu_supports("sse2");
+
+    if(candidates.numOfParties <= maxVectorParties){
+        if(hasAVX2 && fixedIssues > 0) done = countStancesWonIssuesAVX2<fixedIssues>(voters, candidates, firstCluster, count, stancesWon);
+        else if(hasAVX2) done = countStancesWonAVX2<fixedIssues>(voters, candidates, firstCluster, count, stancesWon);
+        else if(hasSSE2) done = countStancesWonSSE2<fixedIssues>(voters, candidates, firstCluster, count, stancesWon);
+    }
+#endif
+
+    countStancesWonScalar<fixedIssues>(voters, candidates, firstCluster, count, done, stancesWon);
+}
+
+// function used to count the stances won by each candidate for a block of clusters
+// 5, 8 and 16 issues use the versions of the kernel made for them, any other number of issues
+// uses the version that reads the number of issues when it runs.
+void countStancesWon(VoterStore& voters, CandidateMatrix& candidates, int firstCluster, int count, uint8_t* stancesWon){
+
+    switch(candidates.numOfIssues){
+        case 5: countStancesWonFor<5>(voters, candidates, firstCluster, count, stancesWon); break;
+        case 8: countStancesWonFor<8>(voters, candidates, firstCluster, count, stancesWon); break;
+        case 16: countStancesWonFor<16>(voters, candidates, firstCluster, count, stancesWon); break;
+        default: countStancesWonFor<0>(voters, candidates, firstCluster, count, stancesWon); break;
+    }
 }
 
-/*  End of Event functions */
+/*  End of vote tally kernel functions */
 
 
 /*  Start of General functions */
@@ -2,162 +2,423 @@
 #define ELECTIONLIBRARY_H_INCLUDED
 
 //include statements for various functions
-#include <map>
 #include <vector>
 #include <random>
+#include <string>
+#include <ostream>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <memory>
+#include <array>
+#include <chrono>
 
 // Enum classes
 // Characteristics will be used by Person(Inherited by Managerial Team & Candidates)
 // which will be used to identify characteristic trait values
 enum class Characteristic{POPULARITY, CHARISMA, EVENTHANDLE, DEBATING};
+// the number of Characteristics, used for the size of the characteristics array in Person
+const int NUM_OF_CHARACTERISTICS = 4;
 // IssueType used by Issue and Event to identify specific issue types
 enum class IssueType{ECONOMIC, SOCIAL, LOGISTICS, ENVIRONMENTAL, HEALTH};
 // Event type which is used by the event class to identify the specific events
 enum class EventType{DEBATE, CANDIDATE_RELATED, LEADER_RELATED, ISSUE_RELATED};
 
+// RandomStream identifies which part of the simulation a random stream is used for
+// GENERATION - electorate clusters, CANDIDATE - candidates, LEADER - leaders and managerial teams
+// EVENT_SELECT - rolling for and choosing an event, EVENT - the rolls made while an event is run
+// NATIONAL - influencing an electorate after a national event, TALLY - votes for an electorate
+enum class RandomStream{GENERATION, CANDIDATE, LEADER, EVENT_SELECT, EVENT, NATIONAL, TALLY};
+// NarrationLevel is how much of an election is narrated, each level includes the ones before it
+// SILENT - nothing, SUMMARY - the final results, DAILY - each campaign day, its events and each electorates result,
+// FULL - everything including the election reports and the votes of every cluster
+enum class NarrationLevel{SILENT, SUMMARY, DAILY, FULL};
+// EventInfluence is what an event does to the stances of the voters
+// NONE - nothing, ELECTORATE - every issue of the electorate, STANCE - one issue of the electorate,
+// NATIONAL - every issue of every electorate
+enum class EventInfluence : uint8_t{NONE, ELECTORATE, STANCE, NATIONAL};
+// CampaignOrder is the order the days and electorates of the campaign are run in
+// DAY_MAJOR - every electorate for one day then the next day, ELECTORATE_MAJOR - every day for a block of electorates
+// then the next block, so the clusters and candidates of the block stay in the cache for the whole campaign
+enum class CampaignOrder{DAY_MAJOR, ELECTORATE_MAJOR};
+
+// the most parties an election can have, every election needs at least 2
+const int MAX_PARTIES = 64;
+// the fewest and most issues an election can have
+const int MIN_ISSUES = 3;
+const int MAX_ISSUES = 64;
+// the most people a generated electorate can have, 100000000 electorates of it still add up to less than INT64_MAX
+const int64_t MAX_ELECTORATE_POPULATION = 10000000000;
+
+// StanceRange is the range a party picks the stances of an issue from
+// {lowest significance, highest significance, lowest approach, highest approach}
+typedef std::array<int, 4> StanceRange;
+
+// the number of Philox blocks of 4 random numbers the generator makes at once
+const int RANDOM_BUFFER_BLOCKS = 4;
+const int RANDOM_BUFFER_SIZE = RANDOM_BUFFER_BLOCKS * 4;
+
 //declaring Party up here so Candidate can use it
 class Party;
 
 // Random Generator class which includes certain random functionalities
+// Each election owns its own generator so that elections never share random state
+// The generator is counter based (Philox4x32-10), every stream is identified by
+// the seed, run, day, electorate and RandomStream, so a roll never depends on
+// what order the rest of the simulation was run in.
+// the numbers are made a few blocks at a time into block and handed out from blockIndex,
+// randomIntRange can fill a whole array of rolls from it at once.
 class RandomGenerator{
     private:
-    static std::default_random_engine randomEngine;
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t block[RANDOM_BUFFER_SIZE];
+    int blockIndex;
+    bool hasSpareNormal;
+    double spareNormal;
+    uint64_t draws;
+
+    void nextBlocks();
+    uint32_t nextInt();
+    double nextDouble();
+    double nextNormal();
 
     public:
-    static int shuffledArray[3];
+    RandomGenerator(uint64_t, uint32_t);
+    void setStream(RandomStream, uint32_t, uint32_t);
     int randomIntRange(int, int);
+    void randomIntRange(int, int, int*, int);
+    int64_t randomIntRange64(int64_t, int64_t);
     int standardDeviation(int, int);
-    void shuffleArray();
+    int64_t standardDeviation64(int64_t, int64_t);
+    void randomPair(int, int&, int&);
+    void setRun(uint32_t);
+    uint64_t getNumOfDraws();
 
 };
 
 // Issue class used to hold information about the 5 different issues
+// id is the index of the issue in the elections issues vector
 // code variable is a small string which holds a small few word summary
 // statement is used to hold the full statement of the issue
 class Issue{
     private:
+    int id;
     std::string code;
     std::string statement;
     IssueType type;
 
     public:
-    Issue(std::string, std::string, IssueType);
+    Issue(int, std::string, std::string, IssueType);
     Issue(const Issue & issueCopy);
     Issue();
     void setStatement(std::string);
     void setIssueType(IssueType);
     void printIssue();
     IssueType& getIssueType();
-    std::string getIssueCode();
-    std::string getStatement();
+    int getID();
+    const std::string& getIssueCode();
+    const std::string& getStatement();
 
 };
 
+// IssueRegistry holds the one copy of every Issue of the election.
+// Issues are interned by their code so adding the same issue twice returns the id it already has,
+// everything else refers to an issue by its id which is its index in the registry.
+// the issues are shared by the forks of an election, a registry only copies them when an issue is added while they're shared.
+class IssueRegistry{
+    private:
+    std::shared_ptr<std::vector<Issue>> issues;
+
+    public:
+    IssueRegistry();
+    int internIssue(std::string, std::string, IssueType);
+    int findIssue(const std::string&);
+    Issue& getIssue(int);
+    int getNumOfIssues();
+    int getColumnWidth(int);
+    void printIssueCodes();
+};
+
 // Stance class used to hold the approach/significance of each individual issue
-// the issue that the stance is held for is identified by the Issue object within Stance.
+// the issue that the stance is held for is identified by its id in the elections IssueRegistry
+// so a stance is only a few bytes and can be copied without allocating.
 class Stance{
     private:
-    int approach;
-    int significance;
-    Issue issue;
+    uint8_t issueID;
+    int16_t approach;
+    int16_t significance;
 
     public:
-    Stance(Issue, int, int);
-    Stance(Issue, std::string);
+    Stance(int, int, int);
     void setApproach(int);
     void setSignificance(int);
     int getApproach();
     int getSignificance();
-    Issue getIssue();
+    int getIssueID();
+
+};
+
+// EventParticipants is who takes part in an event, NONE - only the electorate, CANDIDATE - one candidate
+// of the electorate, CANDIDATES - two candidates of the electorate, LEADERS - two party leaders
+enum class EventParticipants : uint8_t{NONE, CANDIDATE, CANDIDATES, LEADERS};
+// EventRoll is how the outcome of an event is decided, CONTEST - both participants roll and the highest wins,
+// CHECK - the first participant rolls against a pass roll, CHANCE - a plain roll of 1 - sides against a pass roll
+enum class EventRoll : uint8_t{CONTEST, CHECK, CHANCE};
+// EventTarget is the person an outcome of an event applies to, RANDOM is only used for stances
+// made up for the event
+enum class EventTarget : uint8_t{FIRST, SECOND, WINNER, LOSER, RANDOM};
+// EventText is a value filled into the narration of an event
+enum class EventText : uint8_t{FIRST, SECOND, WINNER, LOSER, PARTY, ELECTORATE, ISSUE};
+
+// the most lines, characteristic changes, narration values and roll terms a single event can have
+const int MAX_EVENT_LINES = 4;
+const int MAX_EVENT_CHANGES = 4;
+const int MAX_EVENT_TEXT_ARGS = 4;
+const int MAX_ROLL_TERMS = 4;
+
+// EventLine is one line of narration of an event, text is the offset of its narration format in the
+// catalog text and args are the values filled into it in order.
+class EventLine{
+    public:
+    uint32_t text;
+    uint8_t numOfArgs;
+    EventText args[MAX_EVENT_TEXT_ARGS];
+};
+
+// EventChange is a characteristic change made by an outcome of an event
+// the change is rangeSign * impactRange / rangeDivisor + handleSign * the managerial teams event handling.
+class EventChange{
+    public:
+    EventTarget target;
+    Characteristic characteristic;
+    int8_t rangeSign;
+    uint8_t rangeDivisor;
+    int8_t handleSign;
+};
 
+// EventOutcome is what happens when an event succeeds or fails, the lines are narrated,
+// the changes are made then the electorate (or nation) is influenced by the stances of source.
+class EventOutcome{
+    public:
+    uint8_t numOfLines;
+    uint8_t numOfChanges;
+    EventInfluence influence;
+    EventTarget source;
+    bool positive;
+    EventLine lines[MAX_EVENT_LINES];
+    EventChange changes[MAX_EVENT_CHANGES];
 };
 
-// Event class used to hold all the information of the random events that can
-// occur throughout the campaign.
-// eventStatement holds the full statement of the event
-// type holds the type of event debat/candidate etc.
-// impactRange is used as a factor when an event occurs.
-// impactChar holds the characteristic that is impacted after the event
-// eventCode is just a unique identifier for each event that is loaded
-// IssueType is a variable only used for event type of ISSUE RELATED and
-// is used to hold the type of issue that is being discussed as part of the event
+// RollTerm is one value added together for the mean of an event roll,
+// either a characteristic of the participant divided by divisor or their managerial teams event handling.
+class RollTerm{
+    public:
+    bool handle;
+    Characteristic characteristic;
+    uint8_t divisor;
+};
+
+// Event class is the compiled dispatch record of one event of the event catalog.
+// Events are plain records so the whole catalog is one flat table, nothing is looked up by name
+// or parsed while the campaign runs.
+// code is the position of the event in the catalog, weight is its chance of being picked out of the catalogs total weight.
+// randomIssue is true when an issue is picked each time the event happens.
+// the roll mean is the sum of meanTerms rolled with deviation, handleBonus adds the event handling after the roll.
+// outcomes[0] happens when the event succeeds (a contest is won or a check passes) and outcomes[1] when it fails.
 class Event{
-    private:
-    std::string eventStatement;
+    public:
+    uint32_t name;
+    int code;
     EventType type;
-    int impactRange;
+    int weight;
+    EventParticipants participants;
+    bool randomIssue;
+    EventRoll roll;
+    uint8_t numOfMeanTerms;
+    RollTerm meanTerms[MAX_ROLL_TERMS];
+    int deviation;
+    bool handleBonus;
+    int numOfSides;
+    int passRoll;
     Characteristic impactChar;
-    IssueType relatedIssue;
-    static int numOfEvents;
-    int eventCode;
+    int impactRange;
+    EventLine statement;
+    EventOutcome outcomes[2];
+};
+
+// AliasTable is used to pick an event by weight with the alias method, one column for each event that can be picked.
+// A column is rolled for then a point of the total weight, if the point is under the threshold of the column
+// the event of the column is picked, otherwise its alias is. Every pick takes two rolls no matter how many events there are.
+class AliasTable{
+    public:
+    int totalWeight;
+    std::vector<uint16_t> codes;
+    std::vector<uint16_t> aliases;
+    std::vector<int> thresholds;
+};
+
+// EventCatalog holds every event that can happen during the campaign, loaded from an event file.
+// text holds the name and narration formats of every event one after another, the events keep offsets into it
+// so the catalog can be copied freely.
+// aliasTables holds an alias table for each state of the day, [0] every event and [1] only the events
+// which can still happen once a leader event has happened that day.
+class EventCatalog{
+    private:
+    std::vector<Event> events;
+    std::string text;
+    AliasTable aliasTables[2];
+
+    uint32_t addText(const std::string&);
+    bool compileLine(const std::string&, EventLine&, std::string&);
+    bool parseDirective(Event&, const std::string&, std::string&);
+    void buildAliasTable(AliasTable&, bool);
 
     public:
-    Event(EventType, std::string, int, Characteristic);
-    std::string getStatement();
-    Characteristic getImpactedChar();
-    int getImpactRange();
-    void setRelatedIssue(IssueType);
-    IssueType getIssueType();
+    void load(const std::string&);
+    int pickEvent(RandomGenerator&, bool);
+    Event& operator[](int);
+    int getNumOfEvents();
+    const char* getText(uint32_t);
 };
 
 
-// ElectorateCluster is used to hold the population and stances for
-// a cluster in an electorate
-// Each cluster has 5 stances for each individual issue with unique approaches/significane
-// for each stance.
-class ElectorateCluster{
-    protected:
-    int population;
-    std::vector<Stance> stances;
 
+// VoterColumns holds the columns of the VoterStore which never change once the clusters have been generated,
+// the population and electorate of each cluster and significance[issue] over every cluster.
+class VoterColumns{
     public:
-    ElectorateCluster(int);
-    void addStance(Stance);
-    void printStances();
-    void updateStance(Issue, int);
-    int getPopulation();
-    std::vector<Stance>& getStances();
+    std::vector<int64_t> population;
+    std::vector<int32_t> electorate;
+    std::vector<std::vector<int16_t>> significance;
+};
+
+// VoterStore is used to hold the population and stances of every electorate cluster
+// in the election. Stances are held as a structure of arrays, approach[issue] and
+// significance[issue] are contiguous arrays over every cluster so the vote tally
+// can compare many clusters at once.
+// Each cluster has a stance for each individual issue with unique approaches/significance.
+// The clusters of an electorate are always stored next to each other and
+// electorate holds the index of the electorate each cluster belongs to.
+// when changeLog is set every change asked of updateStance is added to it, this is used
+// to record the stance changes of each event in the EventJournal.
+// every cluster whose stances are changed is marked dirty and added to dirtyClusters once
+// so the election projection only has to look at the clusters that changed.
+// trackDirty is turned off while campaign workers change the stances of their electorates at the same time,
+// the election marks the clusters they changed once they have finished.
+// influenceClusters moves the approaches of a run of clusters on every issue at once, an issue at a time,
+// so the approach array of each issue is gone through in one pass.
+// only the approaches change during the campaign, the rest of the columns are held in columns which is shared by
+// the stores of the forks of an election and copied before a store changes them while they're shared.
+class VoterStore{
+    private:
+    std::shared_ptr<VoterColumns> columns;
+    std::vector<std::vector<int16_t>> approach;
+    std::vector<int8_t>* changeLog;
+    std::vector<uint8_t> dirty;
+    std::vector<int32_t> dirtyClusters;
+    bool trackDirty;
+
+    void ownColumns();
+
+    public:
+    VoterStore();
+    void setChangeLog(std::vector<int8_t>*);
+    void setDirtyTracking(bool);
+    void setNumOfIssues(int);
+    void reserve(int);
+    int addCluster(int, int64_t);
+    void addClusters(int, const int64_t*, const int32_t*, const int16_t* const*, const int16_t* const*);
+    void setStance(int, int, int, int);
+    void updateStance(int, int, int);
+    void influenceClusters(int, int, const int8_t*, int, const int16_t*, bool);
+    void shareClusters(VoterStore&);
+    void copyApproaches(int16_t*);
+    void setApproaches(const int16_t*);
+    void markDirty(int);
+    void clearDirty();
+    std::vector<int32_t>& getDirtyClusters();
+    void printStances(int, IssueRegistry&);
+    int getNumOfClusters();
+    int getNumOfIssues();
+    int64_t getPopulation(int);
+    int getApproach(int, int);
+    int getSignificance(int, int);
+    const int16_t* getApproaches(int);
+    const int16_t* getSignificances(int);
+    const int32_t* getElectorates();
+    const int64_t* getPopulations();
+};
+
+// CandidateMatrix packs the stances of every candidate into flat arrays for the vote tally.
+// The values for a candidate are at [electorate][party][issue] in approach and significance,
+// popularityBonus holds 1/4 of each candidates popularity at [electorate][party].
+class CandidateMatrix{
+    public:
+    int numOfParties, numOfIssues;
+    std::vector<int32_t> approach;
+    std::vector<int32_t> significance;
+    std::vector<int32_t> popularityBonus;
 };
 
 // The Electorate class is used to hold information regarding individual electorates.
-// Each electorate has a vector which holds ElectorateClusters
+// The clusters of each electorate are held in the elections VoterStore, the electorate
+// holds the index of its first cluster and how many clusters it has.
 // The totalPopulation of the electorate is based off the total of all clusters.
+// id is the index of the electorate in the elections electorates vector.
+// the name is shared by the copies of the electorate in the forks of the election.
 class Electorate{
     private:
-    std::string name;
-    std::vector<ElectorateCluster> clusters;
-    unsigned int totalPopulation;
+    int id;
+    std::shared_ptr<const std::string> name;
+    int firstCluster;
+    int numOfClusters;
+    int64_t totalPopulation;
 
     public:
-    Electorate(std::vector<Issue>, std::string, int);
-    void addCluster(ElectorateCluster);
-    std::string getName();
-    int getPopulation();
-    void influenceElectorate(std::vector<Stance>, bool);
-    void influenceStance(Stance, bool);
-    void setPopulation(unsigned int);
-    void printElectorate();
-    void printClusters();
-    std::vector<ElectorateCluster>& getClusters();
+    Electorate(int, std::string, int64_t);
+    void addCluster(int);
+    void setClusters(int, int);
+    int getID();
+    const std::string& getName();
+    int64_t getPopulation();
+    int getFirstCluster();
+    int getNumOfClusters();
+    void influenceElectorate(VoterStore&, Stance*, bool, RandomGenerator&);
+    void influenceStance(VoterStore&, Stance, bool, RandomGenerator&);
+    int replayInfluence(VoterStore&, const int8_t*, int);
+    void setPopulation(int64_t);
+    void printElectorate(VoterStore&, IssueRegistry&);
+    void printClusters(VoterStore&, IssueRegistry&);
 
 };
 
 //Person class is a generic class that Candidate/Managerial team inherits from
 //It is used to hold information that each inherited class will use
-//which includes a map of characteristics to identify values of characterists.
+//which includes an array of characteristic values indexed by the Characteristic.
+//Not every person has every characteristic (leaders have no debating and managerial teams
+//only have event handling) so characteristicMask has a bit set for each characteristic the person has.
+// the name is shared by the copies of the person in the forks of the election, setName gives the person a new one.
 class Person{
     protected:
-    std::string name;
-    std::map<Characteristic,unsigned int> characteristics;
+    std::shared_ptr<const std::string> name;
+    unsigned int characteristics[NUM_OF_CHARACTERISTICS];
+    uint8_t characteristicMask;
 
+    void setChar(Characteristic, unsigned int);
 
     public:
     Person(std::string);
     Person();
     void updateChar(Characteristic, int);
     unsigned int getCharValue(Characteristic);
+    bool hasChar(Characteristic);
     void printCharacteristics();
-    std::string getName();
+    const std::string& getName();
     void setName(std::string);
 
 };
@@ -169,30 +430,32 @@ class Person{
 // it also holds information on the stances won for their electorate, totalVotes, and cluster votes
 // this information is all used in the voting system.
 // This also holds a pointer to the party that their a part of.
+// electorateID is the id of the electorate the candidate represents, leaders have no electorate and use -1.
+// the stances never change once they are generated so they are shared by the copies of the candidate in the forks of the election,
+// stances points straight at the first stance of the vector they are held in so reading them is a single step.
 class Candidate: public Person{
     private:
-    std::vector<Stance> stances;
-    std::string electorateRepresented;
-    int totalVotes;
-    int clusterVotes;
-    int stancesWon;
+    std::shared_ptr<Stance> stances;
+    int electorateID;
+    int64_t totalVotes;
+    int64_t clusterVotes;
     Party* relatedParty;
 
     public:
-    Candidate(std::string, int[5][4], std::vector<Issue>);
-    Candidate(std::string, std::string, int[5][4], std::vector<Issue>);
+    Candidate(std::string, const std::vector<StanceRange>&, IssueRegistry&, RandomGenerator&);
+    Candidate(int, std::string, const std::vector<StanceRange>&, IssueRegistry&, RandomGenerator&);
     Candidate();
     void printCandidate();
-    void printStances();
-    std::vector<Stance>& getStances();
-    std::string getElectorateName();
+    void printStances(IssueRegistry&);
+    Stance* getStances();
+    int getElectorateID();
     void setRelatedParty(Party*);
     Party* getRelatedParty();
-    int getTotalVotes();
-    int getClusterVotes();
-    void updateTotalVotes(int);
-    void calculateClusterVotes(int);
-    void updateStancesWon();
+    int64_t getTotalVotes();
+    int64_t getClusterVotes();
+    void updateTotalVotes(int64_t);
+    void setTotalVotes(int64_t);
+    void calculateClusterVotes(int64_t, int);
 
 };
 
@@ -202,42 +465,496 @@ class Candidate: public Person{
 class ManagerialTeam: public Person{
 
     public:
-    ManagerialTeam(std::string);
+    ManagerialTeam(std::string, RandomGenerator&);
     ManagerialTeam();
 
 };
 
+// CandidateTable holds every candidate of the election at [electorate][party]
+// so the candidate for an electorate is found from the electorate and party ids instead of by name.
+// The index of a candidate in the table is used as its id and the candidates for one
+// electorate are next to each other.
+class CandidateTable{
+    private:
+    int numOfParties;
+    std::vector<Candidate> candidates;
+
+    public:
+    CandidateTable();
+    void resize(int, int);
+    void setCandidate(int, int, Candidate);
+    Candidate& getCandidate(int, int);
+    Candidate* getElectorateCandidates(int);
+    int getNumOfParties();
+    int getNumOfElectorates();
+};
+
 //Party class which holds all information for an individual party
-// Uses a map to hold all candidates that are a part of the party which are identified by
-// the electorate they are assigned to.
+// id is the index of the party in the elections parties vector, the candidates of the
+// party are held in the elections CandidateTable under this id.
 // has a leader variable to hold the information on the leader of the part
 // has a ManagerialTeam which can be used by the leader/Candidates.
 // holds information on how many electorates they've won
+// description is printed with the party, it is empty for parties that don't have one
+// stanceRanges is shared by the copies of the party in the forks of the election.
 class Party{
     private:
+    int id;
     std::string name;
+    std::string description;
     Candidate leader;
     ManagerialTeam mngTeam;
-    std::map<std::string, Candidate> candidates;
     int electoratesWon;
 
     public:
-    Party(std::string, Candidate, int[5][4]);
-    void loadCandidate(Candidate);
-    void printParty();
+    Party(int, std::string, std::string, Candidate, const std::vector<StanceRange>&, RandomGenerator&);
+    void printParty(CandidateTable&, IssueRegistry&);
     void updateElectoratesWon();
+    void setElectoratesWon(int);
     int getElectoratesWon();
     Candidate& getLeader();
     ManagerialTeam& getManagerialTeam();
-    std::string getName();
-    std::map<std::string, Candidate>& getCandidates();
-    int stanceRanges[5][4];
+    int getID();
+    const std::string& getName();
+    const std::string& getDescription();
+    std::shared_ptr<const std::vector<StanceRange>> stanceRanges;
+
+
+};
 
+// declaring EventRecord, ElectionStats and DeferredInfluence up here so EventContext can use them
+class EventRecord;
+class ElectionStats;
+class DeferredInfluence;
 
+// EventContext holds who and what an event is happening to while it is processed
+// winner and loser are set once the roll has been made.
+// random, record and stats are the generator the event rolls with, the record it is written to and the stats it counts into,
+// they belong to the election or to the campaign worker running the event.
+// deferDirty is set when a campaign worker runs the event, the candidates electorate is then only marked for the
+// projection once the worker has finished, popularityChanged says if it has to be.
+// when deferred is set the influence of the event is kept in it instead of being applied to the voters.
+class EventContext{
+    public:
+    Candidate* first;
+    Candidate* second;
+    Candidate* winner;
+    Candidate* loser;
+    Electorate* elec;
+    int issue;
+    RandomGenerator* random;
+    EventRecord* record;
+    ElectionStats* stats;
+    bool deferDirty;
+    bool popularityChanged;
+    DeferredInfluence* deferred;
+};
+
+// ScenarioSpec describes a procedurally generated map which is used in place of
+// Electorates.txt and the party candidate files.
+// distribution is how electorate populations are picked, "uniform" picks between first and second
+// and "normal" uses first as the mean and second as the standard deviation.
+// seed is used for the electorate populations so the same map can be kept while the election seed changes.
+// generated is false when the electorates and candidates are loaded from the text files.
+// eventFile is the event catalog the campaign events are loaded from.
+// scenarioFile is a binary scenario file the electorates, clusters, parties and candidates are loaded from instead,
+// empty when there isn't one.
+// numOfParties is how many parties are generated for a generated scenario, 0 loads the parties from Leaders.txt
+// numOfIssues is how many issues are generated for a generated scenario, 0 loads the issues from Issues.txt
+class ScenarioSpec{
+    public:
+    std::string eventFile;
+    std::string scenarioFile;
+    bool generated;
+    int numOfParties;
+    int numOfIssues;
+    std::string distribution;
+    int64_t first, second;
+    uint64_t seed;
+
+    ScenarioSpec();
+    bool parse(std::string, uint64_t);
+};
+
+// ScenarioHeader is the start of a binary scenario file.
+// Every table of the file is fixed width and starts at the offset given in the header (a multiple of 8).
+// text is the string pool, every name in the file is the offset of a null terminated string in it.
+// the cluster tables are stored the same way as the VoterStore, population[clusters], electorate[clusters],
+// then approach[issues][clusters] and significance[issues][clusters] so they can be copied straight in.
+// candidates holds the name of the candidate for each [electorate][party] and ranges holds the
+// StanceRange of each [party][issue].
+const uint32_t SCENARIO_VERSION = 3;
+class ScenarioHeader{
+    public:
+    char magic[4];
+    uint32_t version;
+    uint32_t numOfIssues;
+    uint32_t numOfParties;
+    uint64_t numOfElectorates;
+    uint64_t numOfClusters;
+    uint64_t textOffset, textSize;
+    uint64_t issueOffset, partyOffset, rangeOffset, electorateOffset, clusterOffset, candidateOffset;
+};
+
+// ScenarioIssue is an issue of a binary scenario file, its code, statement and IssueType
+class ScenarioIssue{
+    public:
+    uint32_t code;
+    uint32_t statement;
+    uint32_t type;
+};
+
+// ScenarioParty is a party of a binary scenario file, its name, leader and description
+class ScenarioParty{
+    public:
+    uint32_t name;
+    uint32_t leaderName;
+    uint32_t description;
+};
+
+// ScenarioElectorate is an electorate of a binary scenario file and the clusters that belong to it
+class ScenarioElectorate{
+    public:
+    uint32_t name;
+    uint32_t numOfClusters;
+    uint64_t firstCluster;
+};
+
+// ScenarioFile is a binary scenario file mapped into memory, the tables are used where they are in the file
+// without being read or parsed. The file is checked when it is opened so every offset and name in it can be trusted.
+// data points at the start of the file, on systems without mmap the file is read into buffer instead.
+class ScenarioFile{
+    private:
+    const char* data;
+    size_t size;
+    std::vector<char> buffer;
+
+    bool check();
+
+    public:
+    ScenarioFile();
+    ~ScenarioFile();
+    ScenarioFile(const ScenarioFile&) = delete;
+    ScenarioFile& operator=(const ScenarioFile&) = delete;
+    bool open(const std::string&);
+    void close();
+    const ScenarioHeader& getHeader();
+    const char* getText(uint32_t);
+    const ScenarioIssue* getIssues();
+    const ScenarioParty* getParties();
+    const int32_t* getStanceRanges(int);
+    const ScenarioElectorate* getElectorates();
+    const int64_t* getPopulations();
+    const int32_t* getClusterElectorates();
+    const int16_t* getApproaches(int);
+    const int16_t* getSignificances(int);
+    const uint32_t* getCandidateNames();
+    static bool write(const std::string&, IssueRegistry&, std::vector<Party>&, std::vector<Electorate>&, VoterStore&, CandidateTable&);
+};
+
+// NarrationArg is one value filled into a narration message, either text or a number.
+// text is never copied so it has to stay alive until the message has been written.
+class NarrationArg{
+    public:
+    bool isText;
+    const char* text;
+    int64_t number;
+};
+
+// NarrationRecord is one narration message waiting to be written.
+// format is the message with a %s or %d placeholder for each of the args, it is only
+// filled in by the writer thread.
+const int MAX_NARRATION_ARGS = 6;
+class NarrationRecord{
+    public:
+    const char* format;
+    int numOfArgs;
+    NarrationArg args[MAX_NARRATION_ARGS];
+};
+
+// NarrationSink is where an election writes its narration.
+// Messages below the level of the sink are dropped before anything is formatted.
+// Any thread can add messages to the ring, a lock-free bounded queue where each slot's sequence
+// number says whether it is free or holds a message. A background writer thread takes the
+// messages out in order, formats them into a large block and writes the block out when it is
+// full or when a flush is asked for, so output is never written a line at a time.
+// flush waits until everything added so far has been written, the writer only runs when narrating.
+class NarrationSink{
+    private:
+    class Slot{
+        public:
+        std::atomic<uint64_t> sequence;
+        NarrationRecord record;
+    };
+
+    NarrationLevel level;
+    FILE* output;
+    std::unique_ptr<Slot[]> ring;
+    uint64_t ringSize;
+    alignas(64) std::atomic<uint64_t> addPos;
+    alignas(64) std::atomic<uint64_t> writtenPos;
+    std::atomic<uint64_t> flushPos;
+    std::atomic<bool> running;
+    std::thread writer;
+
+    void addRecord(NarrationRecord&);
+    void runWriter();
+    void formatRecord(NarrationRecord&, std::string&);
+    static NarrationArg makeArg(const char*);
+    static NarrationArg makeArg(const std::string&);
+    static NarrationArg makeArg(int64_t);
+
+    public:
+    NarrationSink(NarrationLevel, FILE* narrationOutput = stdout);
+    ~NarrationSink();
+    NarrationSink(const NarrationSink&) = delete;
+    NarrationSink& operator=(const NarrationSink&) = delete;
+    bool isEnabled(NarrationLevel);
+    NarrationLevel getLevel();
+    void flush();
+
+    template<typename... Args>
+    void narrate(NarrationLevel messageLevel, const char* format, const Args&... args);
+};
+
+// function used to add a message to the narration
+// nothing is done if the sink's level doesn't include the message so the message is never formatted
+template<typename... Args>
+void NarrationSink::narrate(NarrationLevel messageLevel, const char* format, const Args&... args){
+
+    if(!isEnabled(messageLevel)) return;
+
+    static_assert(sizeof...(Args) <= MAX_NARRATION_ARGS, "too many narration arguments");
+
+    NarrationRecord record;
+    record.format = format;
+    record.numOfArgs = 0;
+    ((record.args[record.numOfArgs++] = makeArg(args)), ...);
+
+    addRecord(record);
+}
+
+// function used to check if a message of the level given is narrated
+inline bool NarrationSink::isEnabled(NarrationLevel messageLevel){
+    return messageLevel != NarrationLevel::SILENT && messageLevel <= level;
+}
+
+// CharacteristicChange is one change made to the characteristic of a candidate or leader by an event
+// party is the party of the person and leader is 1 if the person is the party leader.
+class CharacteristicChange{
+    public:
+    int8_t party;
+    uint8_t leader;
+    uint8_t characteristic;
+    int8_t change;
+};
+
+// EventRecord is one event of the campaign in an EventJournal, every record is the same size.
+// participants are the parties of the candidates/leaders in the event, -1 when there isn't one.
+// rolls are the rolls made for each participant and winner is the party that won the event, -1 for none.
+// The stance changes made by the event are held in the journal's stanceDeltas starting at
+// firstStanceDelta, in the order influence goes through the clusters and issues.
+const int MAX_CHARACTERISTIC_CHANGES = 4;
+class EventRecord{
+    public:
+    uint64_t firstStanceDelta;
+    uint32_t numOfStanceDeltas;
+    int32_t electorate;
+    uint16_t day;
+    int16_t rolls[2];
+    uint16_t eventCode;
+    EventInfluence influence;
+    uint8_t issue;
+    int8_t participants[2];
+    int8_t winner;
+    uint8_t numOfCharChanges;
+    CharacteristicChange charChanges[MAX_CHARACTERISTIC_CHANGES];
+};
+
+// EventJournal is a compact binary record of a campaign, one EventRecord for each event
+// and a side array of every stance change as a signed byte.
+// The header holds everything needed to generate the same starting election again so
+// the campaign can be replayed from the journal without any random rolls.
+class EventJournal{
+    public:
+    uint64_t seed;
+    uint32_t runNumber;
+    int numOfElectorates, numOfDays;
+    ScenarioSpec scenario;
+    std::vector<EventRecord> records;
+    std::vector<int8_t> stanceDeltas;
+
+    bool save(const std::string&);
+    bool load(const std::string&);
+};
+
+// Projection is the result the election would have if the votes were tallied now without the random vote rolls.
+// seats holds how many electorates each party is leading in and votes the expected votes of each party,
+// every cluster gives each party the population/number of issues votes for every stance it wins.
+class Projection{
+    public:
+    std::vector<int> seats;
+    std::vector<int64_t> votes;
+    int64_t totalVotes;
+};
+
+// StatsPhase identifies the part of an election a PhaseTimer measures
+// GENERATE - generateElection, CAMPAIGN - runCampaign (or replayCampaign), POPULARITY - calculatePopularity,
+// TALLY - tallyVotes, WINNER - determineWinner
+enum class StatsPhase{GENERATE, CAMPAIGN, POPULARITY, TALLY, WINNER};
+const int NUM_OF_STATS_PHASES = 5;
+// the number of EventTypes, used for the size of the events counted by ElectionStats
+const int NUM_OF_EVENT_TYPES = 4;
+
+// ElectionStats holds the instrumentation of an election, or of a whole batch once the elections are added together.
+// phaseNanos is the wall time spent in each phase and phaseCalls how many times it was run,
+// eventsByType counts the campaign events by EventType, influenceCalls every time an electorate was influenced
+// and clustersTouched the clusters those influences changed, randomDraws is every 32 bit number drawn from the generator.
+// Every election counts into its own stats so the counters are never shared between threads, a batch worker adds
+// the stats of its elections together and only adds them to the batch once it has finished.
+// Building with ELECTION_NO_STATS compiles every timer and counter out.
+#ifdef ELECTION_NO_STATS
+const bool STATS_ENABLED = false;
+#define STATS_PHASE(stats, phase)
+#define STATS_ADD(counter, value)
+#else
+const bool STATS_ENABLED = true;
+#define STATS_PHASE(stats, phase) PhaseTimer phaseTimer(stats, phase)
+#define STATS_ADD(counter, value) ((counter) += (value))
+#endif
+class ElectionStats{
+    public:
+    uint64_t elections;
+    uint64_t phaseNanos[NUM_OF_STATS_PHASES];
+    uint64_t phaseCalls[NUM_OF_STATS_PHASES];
+    uint64_t eventsByType[NUM_OF_EVENT_TYPES];
+    uint64_t influenceCalls;
+    uint64_t clustersTouched;
+    uint64_t randomDraws;
+
+    ElectionStats();
+    void add(ElectionStats&);
+    void printStats();
+    bool writeJson(const std::string&);
+};
+
+// PhaseTimer adds the wall time from when it is created until it is destroyed to a phase of an ElectionStats
+class PhaseTimer{
+    private:
+    ElectionStats& stats;
+    StatsPhase phase;
+    std::chrono::steady_clock::time_point start;
+
+    public:
+    PhaseTimer(ElectionStats&, StatsPhase);
+    ~PhaseTimer();
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+};
+
+// DeferredInfluence is the influence of a leader event kept by the electorate major campaign so it can be applied
+// to each electorate at the point of the campaign it would have been applied to it in the day major order.
+// day and electorate are where the event happened, stances are the stances of the source for ELECTORATE and NATIONAL
+// influence and stance the stance used for STANCE influence.
+// random is the events generator where the influence started rolling, ELECTORATE and STANCE influence carry on from it,
+// draws is how many draws it had made then so only the draws of the influence are counted in the stats.
+class DeferredInfluence{
+    public:
+    int day;
+    int electorate;
+    EventInfluence influence;
+    bool positive;
+    Stance* stances;
+    Stance stance;
+    RandomGenerator random;
+    uint64_t draws;
+
+    DeferredInfluence();
+};
+
+// declaring Election up here so CampaignScheduler can use it
+class Election;
+
+// CampaignWorker is what one thread of the parallel campaign runs the events of its electorates with,
+// its own generator, the record of the event it is running and its own stats.
+class CampaignWorker{
+    public:
+    RandomGenerator random;
+    EventRecord record;
+    ElectionStats stats;
+
+    CampaignWorker(uint64_t, uint32_t);
+};
+
+// CampaignScheduler runs a task of the election for every electorate of a segment of a campaign day on a pool of threads.
+// The segment is split into chunks of electorates and each worker starts with an even share of the chunks,
+// it takes chunks from the front of its own share and once that is empty steals chunks from the back of the
+// other workers shares, so workers that finish early help the ones with slower electorates.
+// Each share is its front and back chunk packed into one atomic so taking and stealing are a single compare and swap.
+// The thread running the campaign works on every segment as worker 0, the other threads wait for the next segment.
+// task is called with the index of the worker and the electorate, or rangeTask with the index of the worker and the
+// first and last electorate of each chunk for work that is done across electorates.
+class CampaignScheduler{
+    private:
+    class WorkShare{
+        public:
+        alignas(64) std::atomic<uint64_t> chunks;
+    };
+
+    Election& election;
+    int numOfWorkers;
+    std::unique_ptr<WorkShare[]> shares;
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable segmentStarted;
+    std::condition_variable segmentFinished;
+    uint64_t segmentNumber;
+    int busyWorkers;
+    bool stopping;
+    void (Election::*task)(int, int);
+    void (Election::*rangeTask)(int, int, int);
+    int firstElectorate, lastElectorate, chunkSize;
+
+    void runChunks(int, int);
+    void runThread(int);
+    void runShare(int);
+    bool takeChunk(int, int&);
+
+    public:
+    CampaignScheduler(Election&, int);
+    ~CampaignScheduler();
+    CampaignScheduler(const CampaignScheduler&) = delete;
+    CampaignScheduler& operator=(const CampaignScheduler&) = delete;
+    void runSegment(void (Election::*)(int, int), int, int);
+    void runSegment(void (Election::*)(int, int, int), int, int);
+};
+
+// ElectionSnapshot is everything about an election that changes once it has been generated, taken by Election::snapshot
+// so the election can be restored to it or forked from it. The rest of the election is left out as it never changes.
+// the random streams are counter based so where they are is only the run number and the campaign day,
+// campaignDay is the last day of the campaign that has been run and daysLeft how many days are left after it.
+// approaches holds the approach of every cluster [issue][cluster], characteristics the characteristics of every candidate
+// [electorate][party][characteristic] then of every leader [party][characteristic] (they are always 0 - 100),
+// votes the total votes of every candidate and electoratesWon the electorates won by every party.
+// electorateWinners, winningParty and hungParliament are the result when the snapshot is taken after the votes are tallied.
+class ElectionSnapshot{
+    public:
+    uint32_t runNumber;
+    int campaignDay;
+    int daysLeft;
+    std::vector<int16_t> approaches;
+    std::vector<uint8_t> characteristics;
+    std::vector<int64_t> votes;
+    std::vector<int> electoratesWon;
+    std::vector<int> electorateWinners;
+    int winningParty;
+    bool hungParliament;
+
+    ElectionSnapshot();
 };
 
 // Election class which holds ALL information of the election
-// vectors hold all Parties, Electorates, Issues and Events
+// vectors hold all Parties, Electorates and Events, the Issues are held in the IssueRegistry
 // numOfElectorates and numOfDays are collected by the main(upon execution)
 // and fed into the election class to use.
 // The election class is the main class of the system which is used to
@@ -245,16 +962,111 @@ class Party{
 // It also holds the functions for processing events, reporting on the election,
 // the voteTally system and closing the election as well as a handfull of
 // smaller functions used for basic calculations.
+// narration is the sink all campaign/voting output is written to at the level the election was created with,
+// it is the last member so it finishes writing before the names it refers to are destroyed.
+// candidates holds the candidate of every party for every electorate.
+// electorateWinners holds the index of the winning party for each electorate after tallyVotes.
+// stancesWon is the buffer the vote tally counts the stances won for a block of clusters into.
+// Everything used by the campaign and tally is allocated when the election is generated so
+// running the campaign and tallying the votes never allocates.
+// voters holds the clusters of every electorate and candidateMatrix is the packed copy
+// of the candidates stances used by the vote tally.
+// scenario describes the generated map when the election isn't loaded from the text files.
+// random is the elections own generator, all random rolls for the election come from it
+// so separate elections can be run at the same time on different threads.
+// seed and runNumber identify the random streams of the election.
+// campaignDay holds the day of the campaign currently being run, counting up from 1.
+// journal is where the events of the campaign are recorded, nullptr when they aren't,
+// currentRecord is the record of the event being run.
+// projection is kept up to date by currentProjection, projectedStancesWon caches the stances won by each party
+// for each cluster [cluster][party], projectedVotes the expected votes of each candidate [electorate][party]
+// and projectedWinners the party leading each electorate (-1 for none).
+// electorates whose candidates popularity has changed are marked in electorateDirty and added to dirtyElectorates.
+// pollOutput is where a poll of the projection is written after each campaign day, nullptr when there are no polls.
+// stats holds the phase timings and counters of the election.
+// campaignThreads is how many threads run the campaign, the campaign is run in parallel when it is more than 1.
+// campaignOrder is the order the days and electorates of the campaign are run in, leaderElectorates holds the first
+// electorate to pick a leader event each day (the number of electorates for none) and leaderInfluences the influence
+// of that days leader event for the electorate major campaign.
+// campaignWorkers are the workers of the parallel campaign, dayEvents holds the event picked by each electorate
+// for the current day (-1 for none) and dayChanges what each electorates event changed, sharedEvents marks the
+// events of the catalog that change more than their own electorate.
+// campaignScheduler is the scheduler of the parallel campaign while it is running, nullptr otherwise,
+// national influence is split between its workers with nationalStances and nationalPositive holding the influence.
+// campaignDraws holds the random draws of the workers and leader influences of the campaigns run before the last one.
+// The campaign can be run a few days at a time with runCampaign(days), snapshot and restore save and rewind the election
+// between days and fork makes a new election from where this one is up to, which shares everything that never changes
+// with it, so many different futures can be run from the same day without running the days before it again.
 class Election{
     private:
     int numOfElectorates, numOfDays;
+    uint64_t seed;
+    uint32_t runNumber;
+    RandomGenerator random;
     std::vector<Party> parties;
     std::vector<Electorate> electorates;
-    std::vector<Issue> issues;
-    std::vector<Event> events;
+    CandidateTable candidates;
+    VoterStore voters;
+    CandidateMatrix candidateMatrix;
+    ScenarioSpec scenario;
+    IssueRegistry issues;
+    EventCatalog events;
+    std::vector<int> electorateWinners;
+    std::vector<uint8_t> stancesWon;
+    int campaignDay;
+    int winningParty;
+    bool hungParliament;
+    EventJournal* journal;
+    EventRecord currentRecord;
+    Projection projection;
+    std::vector<uint8_t> projectedStancesWon;
+    std::vector<int64_t> projectedVotes;
+    std::vector<int> projectedWinners;
+    std::vector<uint8_t> electorateDirty;
+    std::vector<int32_t> dirtyElectorates;
+    bool projectionBuilt;
+    std::ostream* pollOutput;
+    int campaignThreads;
+    CampaignOrder campaignOrder;
+    std::vector<int> leaderElectorates;
+    std::vector<DeferredInfluence> leaderInfluences;
+    std::vector<CampaignWorker> campaignWorkers;
+    std::vector<int> dayEvents;
+    std::vector<uint8_t> dayChanges;
+    std::vector<uint8_t> sharedEvents;
+    CampaignScheduler* campaignScheduler;
+    Stance* nationalStances;
+    bool nationalPositive;
+    uint64_t campaignDraws;
+    ElectionStats stats;
+    NarrationSink narration;
+
+    void startRecord(int, int, int);
+    void finishRecord();
+    void updateCandidateChar(Candidate*, Characteristic, int, EventContext&);
+    int rollForEvent(Event&, Candidate*, EventContext&);
+    Candidate* getEventTarget(EventContext&, EventTarget);
+    void narrateEventLine(EventLine&, EventContext&);
+    void applyOutcome(Event&, EventOutcome&, EventContext&);
+    void buildProjection();
+    void markElectorateDirty(int);
+    void updateProjectedWinner(int);
+    void writePollHeader();
+    void writePoll(int);
+    void runParallelCampaign(int);
+    bool isSharedEvent(Event&);
+    void pickParallelEvent(int, int);
+    void repickParallelEvent(int, int);
+    void runParallelEvent(int, int);
+    void mergeParallelEvents(int, int);
+    void influenceElectorates(Stance*, bool, RandomGenerator&, int, int);
+    void runNationalInfluence(int, int, int);
+    bool canRunElectorateMajor();
+    void runElectorateMajorCampaign(int);
+    void applyDeferredInfluence(DeferredInfluence&, int);
 
     public:
-    Election(int, int);
+    Election(int, int, uint64_t, uint32_t runNumber = 0, NarrationLevel narrationLevel = NarrationLevel::FULL);
     void generateElection();
     void generateParties();
     void generateElectorate();
@@ -262,22 +1074,119 @@ class Election{
     void generateElectorateClusters();
     void loadLeaders();
     void loadElectorates();
+    void generateScenarioElectorates();
+    void generateScenarioParties();
+    void generateScenarioIssues();
+    void setScenario(ScenarioSpec);
     void loadIssues();
     void loadEvents();
     void loadLeadersAndStanceRange();
+    void loadScenarioFile();
+    bool writeScenarioFile(const std::string&);
+    void addParty(const std::string&, const std::string&, const std::string&, const std::vector<StanceRange>&);
+    void addCandidate(int, Party&, const std::string&);
     void calculateElectoratePop();
     void printElection();
     void runCampaign();
+    void runCampaign(int);
     void runElection();
+    bool replayElection(EventJournal&);
+    bool validateJournal(EventJournal&);
+    void replayCampaign(EventJournal&);
+    void setJournal(EventJournal*);
+    void setPollOutput(std::ostream*);
+    void setCampaignThreads(int);
+    void setCampaignOrder(CampaignOrder);
     void finishElection();
     void reportElection();
     void tallyVotes();
     void determineWinner();
-    void calculateClusterVotes(std::vector<Candidate*>*, ElectorateCluster*);
+    void setUpTally();
+    void buildCandidateMatrix();
     void calculatePopularity();
-    int getEvent();
+    Projection& currentProjection();
+    int getEvent(bool);
     void handleEvent(int, Electorate*);
-    void processEvent(int, Candidate*, Candidate*, Electorate*);
+    void handleEvent(int, Electorate*, EventContext&);
+    void processEvent(Event&, EventContext&);
+    void influenceNation(Stance*, bool);
+    ElectionSnapshot snapshot();
+    void restore(ElectionSnapshot&);
+    void restore(ElectionSnapshot&, uint32_t);
+    std::unique_ptr<Election> fork(uint32_t, NarrationLevel narrationLevel = NarrationLevel::SILENT);
+    std::vector<Party>& getParties();
+    std::vector<Electorate>& getElectorates();
+    CandidateTable& getCandidates();
+    VoterStore& getVoters();
+    CandidateMatrix& getCandidateMatrix();
+    EventCatalog& getEvents();
+    std::vector<int>& getElectorateWinners();
+    int getWinningParty();
+    bool isHungParliament();
+    int getCampaignDay();
+    uint64_t getSeed();
+    ElectionStats& getStats();
+
+};
+
+// BatchRunResult is the result of one run of a batch, kept when the batch records its runs
+// electorateWinners holds the party that won each electorate and electoratesWon the seats of each party.
+class BatchRunResult{
+    public:
+    std::vector<int> electorateWinners;
+    std::vector<int> electoratesWon;
+    int winningParty;
+    bool hungParliament;
+
+    BatchRunResult();
+};
+
+// BatchSimulator is used to run many independent elections in one process
+// for monte carlo style results. Each run goes through the normal
+// generateElection -> runElection -> finishElection pipeline with narration switched off.
+// Runs are handed out to a pool of worker threads, each worker keeps its own
+// totals and only merges them into the batch totals once it has finished.
+// seatCounts holds how many times each party finished with a given number of seats [party][seats]
+// electorateWins holds how many times each party won each electorate [electorate][party]
+// stats holds the phase timings and counters of every election of the batch added together
+// campaignOrder is the order every election of the batch runs its campaign in
+// when branchDay is set (it is -1 when it isn't) one election is generated and run up to the end of that day as trunk,
+// every run of the batch is then a different future from branchPoint run on a fork of the trunk kept by each worker.
+// when recordRuns is set the result of every run is also kept in runResults [run], each run is only written by the
+// worker that ran it so they don't need the lock.
+class BatchSimulator{
+    private:
+    int numOfElectorates, numOfDays, numOfRuns, numOfThreads;
+    uint64_t seed;
+    ScenarioSpec scenario;
+    std::vector<std::string> partyNames;
+    std::vector<std::string> electorateNames;
+    std::vector<std::vector<long>> seatCounts;
+    std::vector<std::vector<long>> electorateWins;
+    std::vector<long> electionsWon;
+    long hungParliaments;
+    CampaignOrder campaignOrder;
+    int branchDay;
+    std::unique_ptr<Election> trunk;
+    ElectionSnapshot branchPoint;
+    bool recordRuns;
+    std::vector<BatchRunResult> runResults;
+    ElectionStats stats;
+    std::atomic<int> nextRun;
+    std::mutex resultsLock;
+
+    void runWorker();
+
+    public:
+    BatchSimulator(int, int, int, int, uint64_t);
+    void setScenario(ScenarioSpec);
+    void setCampaignOrder(CampaignOrder);
+    void setBranchDay(int);
+    void setRecordRuns(bool);
+    void runBatch();
+    void reportBatch();
+    std::vector<BatchRunResult>& getRunResults();
+    ElectionStats& getStats();
 
 };
 
@@ -292,5 +1201,11 @@ std::ostream& operator << (std::ostream&, const Characteristic&);
 // used when calculating votes and checking stance ranges.
 int getRange(int,int);
 
+// vote tally kernel which finds the candidate with the closest stance on every issue
+// for a block of clusters and counts the stances won by each candidate.
+// stancesWon is filled in as [party][cluster - firstCluster].
+// uses AVX2 or SSE2 when the cpu supports it and falls back to plain loops otherwise.
+void countStancesWon(VoterStore&, CandidateMatrix&, int, int, uint8_t*);
+
 
 #endif // ELECTIONLIBRARY_H_INCLUDED
@@ -0,0 +1,74 @@
+//include statements for various functions
+#include <iostream>
+#include <string>
+#include "ElectionLibrary.h"
+
+using namespace std;
+
+// function used to check the winner of every electorate of a tallied election
+// every candidate needs a vote count of 0 or more and the winner has to be the first candidate with the most votes.
+// prints the first electorate that is wrong and returns false
+bool checkElectorateWinners(Election& election){
+
+    CandidateTable& candidates = election.getCandidates();
+    vector<int>& winners = election.getElectorateWinners();
+    int numOfParties = election.getParties().size();
+
+    if(winners.size() != election.getElectorates().size()){
+        cout<<"  "<<winners.size()<<" electorates have a winner out of "<<election.getElectorates().size()<<endl;
+        return false;
+    }
+
+    for(unsigned int elecIndex = 0; elecIndex < winners.size(); elecIndex++){
+        int mostVotes = 0;
+        for(int partyIndex = 0; partyIndex < numOfParties; partyIndex++){
+            int64_t votes = candidates.getCandidate(elecIndex, partyIndex).getTotalVotes();
+            if(votes < 0){
+                cout<<"  electorate "<<elecIndex<<" party "<<partyIndex<<" has "<<votes<<" votes"<<endl;
+                return false;
+            }
+            if(votes > candidates.getCandidate(elecIndex, mostVotes).getTotalVotes()) mostVotes = partyIndex;
+        }
+        if(winners[elecIndex] != mostVotes){
+            cout<<"  electorate "<<elecIndex<<" was won by party "<<winners[elecIndex]<<" but party "<<mostVotes<<" has the most votes"<<endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// function used to run one generated election to the end and check its electorate winners
+// spec is the --generate map, with numOfParties parties and numOfIssues issues generated for it.
+bool runElectionCase(const string& name, int electorates, int days, uint64_t seed, const string& spec, int numOfParties, int numOfIssues){
+
+    ScenarioSpec scenario;
+    scenario.parse(spec, seed);
+    scenario.numOfParties = numOfParties;
+    scenario.numOfIssues = numOfIssues;
+
+    Election election(electorates, days, seed, 0, NarrationLevel::SILENT);
+    election.setScenario(scenario);
+    election.generateElection();
+    election.runElection();
+    election.finishElection();
+
+    bool passed = checkElectorateWinners(election);
+    cout<<(passed ? "ok   " : "FAIL ")<<name<<endl;
+    return passed;
+}
+
+// Main function which runs every regression case
+// returns 1 if any case fails, a case that crashes fails the test as well
+int main(){
+
+    cout<<"# Election Simulator regression test"<<endl;
+
+    bool passed = true;
+    // the smallest electorates split between 64 issues used to leave every candidate without a positive vote count,
+    // the winner was then never set: "<exe> 1 1 --generate uniform:100:100 --parties 3 --issues 64 --seed 19"
+    passed &= runElectionCase("small electorates/issues=64", 1, 1, 19, "uniform:100:100", 3, 64);
+    passed &= runElectionCase("small electorates/issues=64/electorates=300", 300, 1, 1, "uniform:100:100", 3, 64);
+
+    return passed ? 0 : 1;
+}
@@ -1,38 +1,377 @@
 //include statements for various functions
 #include <iostream>
 #include <iomanip>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <random>
 #include "ElectionLibrary.h"
 
 using namespace std;
 
+// function used to read the --narration argument
+// returns false if the level is unknown
+bool parseNarrationLevel(const string& level, NarrationLevel& narrationLevel){
+    if(level == "silent") narrationLevel = NarrationLevel::SILENT;
+    else if(level == "summary") narrationLevel = NarrationLevel::SUMMARY;
+    else if(level == "daily") narrationLevel = NarrationLevel::DAILY;
+    else if(level == "full") narrationLevel = NarrationLevel::FULL;
+    else{
+        cerr<<"Unknown narration level "<<level<<", use silent, summary, daily or full"<<endl;
+        return false;
+    }
+    return true;
+}
+
+// function used to read the --campaign-order argument
+// returns false if the order is unknown
+bool parseCampaignOrder(const string& order, CampaignOrder& campaignOrder){
+    if(order == "day") campaignOrder = CampaignOrder::DAY_MAJOR;
+    else if(order == "electorate") campaignOrder = CampaignOrder::ELECTORATE_MAJOR;
+    else{
+        cerr<<"Unknown campaign order "<<order<<", use day or electorate"<<endl;
+        return false;
+    }
+    return true;
+}
+
+// function used to print the summary of the stats given with --stats then write them to the stats file as JSON
+// returns 1 if the file can't be written
+int writeStats(ElectionStats& stats, const string& statsFile){
+    stats.printStats();
+    if(!stats.writeJson(statsFile)){
+        cerr<<"Unable to write stats "<<statsFile<<endl;
+        return 1;
+    }
+    return 0;
+}
+
+// function used to check the --stats argument can be used, the stats are compiled out when built with ELECTION_NO_STATS
+bool validStatsFile(const string& statsFile){
+    if(!statsFile.empty() && !STATS_ENABLED){
+        cerr<<"--stats can't be used, the simulator was built with ELECTION_NO_STATS"<<endl;
+        return false;
+    }
+    return true;
+}
+
+// function used to replay an election from a journal saved with --journal
+// the election is generated again from the journal's seed and scenario then the campaign is
+// rebuilt from the recorded events instead of being simulated.
+int replayJournal(const string& fileName, NarrationLevel narrationLevel, const string& pollFile, const string& statsFile){
+
+    EventJournal journal;
+    if(!journal.load(fileName)){
+        cerr<<"Unable to read journal "<<fileName<<endl;
+        return 1;
+    }
+
+    Election election = Election(journal.numOfElectorates, journal.numOfDays, journal.seed, journal.runNumber, narrationLevel);
+    election.setScenario(journal.scenario);
+
+    election.generateElection();
+
+    if(narrationLevel == NarrationLevel::FULL) election.printElection();
+
+    ofstream polls;
+    if(!pollFile.empty()){
+        polls.open(pollFile);
+        if(!polls.is_open()){
+            cerr<<"Unable to write polls "<<pollFile<<endl;
+            return 1;
+        }
+        election.setPollOutput(&polls);
+    }
+
+    if(!election.replayElection(journal)){
+        cerr<<"Journal "<<fileName<<" doesn't match the election it was recorded from"<<endl;
+        return 1;
+    }
+
+    election.finishElection();
+
+    if(!statsFile.empty()) return writeStats(election.getStats(), statsFile);
+
+    return 0;
+}
+
+// function used to check the --parties and --issues arguments, parties and issues can only be generated
+// for a generated scenario and the parties of Leaders.txt only have stance ranges for the issues of Issues.txt
+// so issues can only be generated with the parties.
+// returns false if the number of parties or issues can't be used
+bool validGeneratedCounts(int numOfParties, int numOfIssues, ScenarioSpec& scenario){
+    if(numOfParties == 0 && numOfIssues == 0) return true;
+    if(!scenario.generated){
+        cerr<<"--parties and --issues can only be used with --generate"<<endl;
+        return false;
+    }
+    if(numOfParties != 0 && (numOfParties < 2 || numOfParties > MAX_PARTIES)){
+        cerr<<"Number of parties must be between 2 - "<<MAX_PARTIES<<" inclusive."<<endl;
+        return false;
+    }
+    if(numOfIssues != 0 && numOfParties == 0){
+        cerr<<"--issues can only be used with --parties"<<endl;
+        return false;
+    }
+    if(numOfIssues != 0 && (numOfIssues < MIN_ISSUES || numOfIssues > MAX_ISSUES)){
+        cerr<<"Number of issues must be between "<<MIN_ISSUES<<" - "<<MAX_ISSUES<<" inclusive."<<endl;
+        return false;
+    }
+    return true;
+}
+
+// function used to convert the text files or a generated scenario into a binary scenario file
+// the electorates, clusters, parties and candidates are generated once and written to the file
+// so later elections can load them with --scenario without generating or parsing them again.
+int convertScenario(int argle, char* argv[]){
+
+    int numOfElectorates = 10;
+    int numOfParties = 0;
+    int numOfIssues = 0;
+    uint64_t seed = 0;
+    string generateSpec;
+    ScenarioSpec scenario;
+
+    for(int x = 3; x < argle; x += 2){
+        string option = argv[x];
+        if(option == "--electorates") numOfElectorates = stoi(argv[x + 1]);
+        else if(option == "--seed") seed = stoull(argv[x + 1]);
+        else if(option == "--generate") generateSpec = argv[x + 1];
+        else if(option == "--parties") numOfParties = stoi(argv[x + 1]);
+        else if(option == "--issues") numOfIssues = stoi(argv[x + 1]);
+        else{
+            cerr<<"Only --electorates, --seed, --generate, --parties and --issues can be used with --convert"<<endl;
+            return 1;
+        }
+    }
+
+    if(!generateSpec.empty() && !scenario.parse(generateSpec, seed)){
+        cerr<<"Invalid scenario "<<generateSpec<<endl;
+        return 1;
+    }
+    if(!validGeneratedCounts(numOfParties, numOfIssues, scenario)) return 1;
+    scenario.numOfParties = numOfParties;
+    scenario.numOfIssues = numOfIssues;
+    if(!scenario.generated && (numOfElectorates > 10 || numOfElectorates < 1)){
+        cerr<<"Number of electorates must be between 1 - 10 inclusive. Use --generate for more electorates."<<endl;
+        return 1;
+    }
+    if(scenario.generated && (numOfElectorates > 100000000 || numOfElectorates < 1)){
+        cerr<<"Number of generated electorates must be between 1 - 100000000 inclusive."<<endl;
+        return 1;
+    }
+
+    Election election = Election(numOfElectorates, 1, seed, 0, NarrationLevel::SILENT);
+    election.setScenario(scenario);
+    election.generateElection();
+
+    if(!election.writeScenarioFile(argv[2])){
+        cerr<<"Unable to write scenario "<<argv[2]<<endl;
+        return 1;
+    }
+    return 0;
+}
+
 // Main function which collects the arguments upon execution
 int main(int argle, char* argv[]){
 
     // if statement to ensure the correct amount of arguments have been provided.
-    if(argle != 3){
-        cerr<<"Please enter valid arguments:\n./<exe> <number of electorates> <number of days for campaign>"<<endl;
+    // the optional --runs, --threads, --seed, --generate, --parties, --issues, --scenario, --narration, --journal, --events, --polls, --stats, --campaign-threads, --campaign-order and --branch-day arguments come after the 2 required arguments
+    // or an election saved with --journal is replayed with --replay <file>
+    // or a scenario file is written with --convert <file>
+    if(argle < 3 || argle % 2 == 0){
+        cerr<<"Please enter valid arguments:\n./<exe> <number of electorates> <number of days for campaign> [--runs <number of elections>] [--threads <number of threads>] [--seed <seed>] [--generate <distribution>:<first>:<second>[:<seed>]] [--parties <number of parties>] [--issues <number of issues>] [--scenario <file>] [--narration <silent|summary|daily|full>] [--journal <file>] [--events <file>] [--polls <file>] [--stats <file>] [--campaign-threads <number of threads>] [--campaign-order <day|electorate>] [--branch-day <day>]\n./<exe> --replay <file> [--narration <silent|summary|daily|full>] [--polls <file>] [--stats <file>]\n./<exe> --convert <file> [--electorates <number of electorates>] [--seed <seed>] [--generate <distribution>:<first>:<second>[:<seed>]] [--parties <number of parties>] [--issues <number of issues>]"<<endl;
         return 1;
     }
+
+    if(string(argv[1]) == "--replay"){
+        NarrationLevel narrationLevel = NarrationLevel::FULL;
+        string pollFile;
+        string statsFile;
+        for(int x = 3; x < argle; x += 2){
+            string option = argv[x];
+            if(option == "--narration"){
+                if(!parseNarrationLevel(argv[x + 1], narrationLevel)) return 1;
+            }
+            else if(option == "--polls") pollFile = argv[x + 1];
+            else if(option == "--stats") statsFile = argv[x + 1];
+            else{
+                cerr<<"Only --narration, --polls and --stats can be used with --replay"<<endl;
+                return 1;
+            }
+        }
+        if(!validStatsFile(statsFile)) return 1;
+        return replayJournal(argv[2], narrationLevel, pollFile, statsFile);
+    }
+
+    if(string(argv[1]) == "--convert") return convertScenario(argle, argv);
+
     int numOfDays, numOfElectorates;
+    int numOfRuns = 0;
+    int numOfParties = 0; // parties are loaded from Leaders.txt unless they are generated
+    int numOfIssues = 0; // issues are loaded from Issues.txt unless they are generated
+    int numOfThreads = thread::hardware_concurrency();
+    int campaignThreads = 1; // the campaign of a single election is run on one thread unless more are asked for
+    int branchDay = -1; // the runs of a batch are separate elections unless they branch from the same election
+    bool runsGiven = false; // the elections are only run as a batch when --runs is given
+    bool branchDayGiven = false;
+    uint64_t seed = ((uint64_t)random_device{}() << 32) | random_device{}(); // random seed unless one is provided
+    string generateSpec; // empty unless the electorates are generated
+    string journalFile; // empty unless the events are journaled
+    string pollFile; // empty unless the daily polls are written
+    string statsFile; // empty unless the stats are written
+    string eventFile = "Events.txt"; // event catalog used for the campaign
+    string scenarioFile; // empty unless the election is loaded from a scenario file
+    ScenarioSpec scenario;
+    NarrationLevel narrationLevel = NarrationLevel::FULL;
+    CampaignOrder campaignOrder = CampaignOrder::DAY_MAJOR; // every day is run for every electorate before the next day
 
     // converts entered values into integers.
     numOfElectorates = stoi(argv[1]);
     numOfDays = stoi(argv[2]);
 
+    // collects the optional arguments used for batch mode
+    for(int x = 3; x < argle; x += 2){
+        string option = argv[x];
+        if(option == "--runs"){
+            numOfRuns = stoi(argv[x + 1]);
+            runsGiven = true;
+        }
+        else if(option == "--threads") numOfThreads = stoi(argv[x + 1]);
+        else if(option == "--seed") seed = stoull(argv[x + 1]);
+        else if(option == "--generate") generateSpec = argv[x + 1];
+        else if(option == "--parties") numOfParties = stoi(argv[x + 1]);
+        else if(option == "--issues") numOfIssues = stoi(argv[x + 1]);
+        else if(option == "--events") eventFile = argv[x + 1];
+        else if(option == "--scenario") scenarioFile = argv[x + 1];
+        else if(option == "--narration"){
+            if(!parseNarrationLevel(argv[x + 1], narrationLevel)) return 1;
+        }
+        else if(option == "--journal") journalFile = argv[x + 1];
+        else if(option == "--polls") pollFile = argv[x + 1];
+        else if(option == "--stats") statsFile = argv[x + 1];
+        else if(option == "--campaign-threads") campaignThreads = stoi(argv[x + 1]);
+        else if(option == "--campaign-order"){
+            if(!parseCampaignOrder(argv[x + 1], campaignOrder)) return 1;
+        }
+        else if(option == "--branch-day"){
+            branchDay = stoi(argv[x + 1]);
+            branchDayGiven = true;
+        }
+        else{
+            cerr<<"Unknown option "<<option<<endl;
+            return 1;
+        }
+    }
+
+    // the scenario is read after the seed so it can default to the election seed
+    if(!generateSpec.empty() && !scenario.parse(generateSpec, seed)){
+        cerr<<"Invalid scenario "<<generateSpec<<". Use uniform:<min population>:<max population>[:<seed>] or normal:<mean population>:<standard deviation>[:<seed>]"<<endl;
+        return 1;
+    }
+    if(!generateSpec.empty() && !scenarioFile.empty()){
+        cerr<<"--generate and --scenario can't be used together"<<endl;
+        return 1;
+    }
+    if(!validGeneratedCounts(numOfParties, numOfIssues, scenario)) return 1;
+    if(!validStatsFile(statsFile)) return 1;
+    scenario.numOfParties = numOfParties;
+    scenario.numOfIssues = numOfIssues;
+    scenario.eventFile = eventFile;
+    scenario.scenarioFile = scenarioFile;
+
     // if statement to validate correct parameters have been provided
-    if((numOfDays > 30 || numOfDays < 1) || (numOfElectorates > 10 || numOfElectorates < 1)){
-        cerr<<"Number of electorates must be between 1 - 10 inclusive. Number of campign days must be 1 - 30 inclusive."<<endl;
+    // the text files only have 10 electorates so more can only be used with a generated scenario or scenario file
+    if(numOfDays > 10000 || numOfDays < 1){
+        cerr<<"Number of campign days must be 1 - 10000 inclusive."<<endl;
+        return 1;
+    }
+    if(!scenario.generated && scenarioFile.empty() && (numOfElectorates > 10 || numOfElectorates < 1)){
+        cerr<<"Number of electorates must be between 1 - 10 inclusive. Use --generate for more electorates."<<endl;
+        return 1;
+    }
+    if(scenario.generated && (numOfElectorates > 100000000 || numOfElectorates < 1)){
+        cerr<<"Number of generated electorates must be between 1 - 100000000 inclusive."<<endl;
+        return 1;
+    }
+    if(!scenarioFile.empty() && (numOfElectorates > 100000000 || numOfElectorates < 1)){
+        cerr<<"Number of electorates must be between 1 - 100000000 inclusive."<<endl;
         return 1;
     }
 
+    if(runsGiven && numOfRuns < 1){
+        cerr<<"Number of runs must be at least 1."<<endl;
+        return 1;
+    }
+
+    if(numOfThreads < 1) numOfThreads = 1;
+
+    // the events of a day are only run in parallel when they don't have to be narrated or journaled in order
+    if(campaignThreads < 1){
+        cerr<<"Number of campaign threads must be at least 1."<<endl;
+        return 1;
+    }
+    if(campaignThreads > 1 && (runsGiven || !journalFile.empty() || narrationLevel >= NarrationLevel::DAILY)){
+        cerr<<"--campaign-threads can only be used for a single election with --narration summary or silent and without --journal"<<endl;
+        return 1;
+    }
+
+    // the electorate major campaign runs every day of an electorate together so the days can't be narrated, journaled or polled
+    // the elections of a batch aren't narrated
+    if(campaignOrder == CampaignOrder::ELECTORATE_MAJOR && (campaignThreads > 1 || !journalFile.empty() || !pollFile.empty() || (!runsGiven && narrationLevel >= NarrationLevel::DAILY))){
+        cerr<<"--campaign-order electorate can only be used with --narration summary or silent and without --journal, --polls or --campaign-threads"<<endl;
+        return 1;
+    }
+
+    // the runs of a batch can branch from the same election at the end of any day of the campaign
+    if(branchDayGiven && (!runsGiven || branchDay < 0 || branchDay > numOfDays)){
+        cerr<<"--branch-day can only be used with --runs and must be between 0 - the number of campaign days inclusive."<<endl;
+        return 1;
+    }
+
+    // if a number of runs was provided the elections are run as a batch
+    // and only the combined results are printed
+    if(runsGiven){
+        if(!journalFile.empty() || !pollFile.empty()){
+            cerr<<"--journal and --polls can only be used for a single election"<<endl;
+            return 1;
+        }
+        BatchSimulator batch(numOfElectorates, numOfDays, numOfRuns, numOfThreads, seed);
+        batch.setScenario(scenario);
+        batch.setCampaignOrder(campaignOrder);
+        batch.setBranchDay(branchDay);
+        batch.runBatch();
+        batch.reportBatch();
+        if(!statsFile.empty()) return writeStats(batch.getStats(), statsFile);
+        return 0;
+    }
+
     //creates Election object and provides the numOfElectorates and days for the campaign
-    Election election = Election(numOfElectorates, numOfDays);
+    Election election = Election(numOfElectorates, numOfDays, seed, 0, narrationLevel);
+    election.setScenario(scenario);
+    election.setCampaignThreads(campaignThreads);
+    election.setCampaignOrder(campaignOrder);
 
     // calls function which runs all functions for generating/loading the election
     election.generateElection();
 
-    // calls function to print all the info of the election.
-    election.printElection();
+    // calls function to print all the info of the election, only when fully narrating.
+    if(narrationLevel == NarrationLevel::FULL) election.printElection();
+
+    // every event of the campaign is recorded when a journal file is provided
+    EventJournal journal;
+    if(!journalFile.empty()) election.setJournal(&journal);
+
+    // a poll of the projected result is written after each campaign day when a poll file is provided
+    ofstream polls;
+    if(!pollFile.empty()){
+        polls.open(pollFile);
+        if(!polls.is_open()){
+            cerr<<"Unable to write polls "<<pollFile<<endl;
+            return 1;
+        }
+        election.setPollOutput(&polls);
+    }
 
     // calls the function which runs all functions to execute the election simulation
     election.runElection();
@@ -40,5 +379,13 @@ int main(int argle, char* argv[]){
     // calls the function which runs all functions which calculates votes and prints the result
     election.finishElection();
 
+    if(!journalFile.empty() && !journal.save(journalFile)){
+        cerr<<"Unable to write journal "<<journalFile<<endl;
+        return 1;
+    }
+
+    // the stats are written once everything else has finished
+    if(!statsFile.empty()) return writeStats(election.getStats(), statsFile);
+
     return 0;
 }
@@ -0,0 +1,109 @@
+//include statements for various functions
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include "ElectionLibrary.h"
+
+using namespace std;
+
+// the number of elections each case runs, once on one thread and once on every test thread at the same time
+static const int stressRuns = 64;
+// the generated map used by the larger cases, the map seed is the test seed
+static const char* stressScenario = "uniform:2000:5000";
+
+// function used to compare the result of every run of two batches
+// prints the first run that differs and returns false if any run differs
+bool compareRuns(vector<BatchRunResult>& serial, vector<BatchRunResult>& concurrent){
+
+    if(serial.size() != concurrent.size()){
+        cout<<"  ran "<<serial.size()<<" elections serially but "<<concurrent.size()<<" concurrently"<<endl;
+        return false;
+    }
+
+    for(unsigned int run = 0; run < serial.size(); run++){
+        BatchRunResult& first = serial[run];
+        BatchRunResult& second = concurrent[run];
+
+        if(first.electorateWinners.empty()){
+            cout<<"  run "<<run<<" has no result"<<endl;
+            return false;
+        }
+        if(first.winningParty != second.winningParty || first.hungParliament != second.hungParliament){
+            cout<<"  run "<<run<<" was won by "<<first.winningParty<<" serially but "<<second.winningParty<<" concurrently"<<endl;
+            return false;
+        }
+        if(first.electorateWinners != second.electorateWinners || first.electoratesWon != second.electoratesWon){
+            cout<<"  run "<<run<<" has different electorate results serially and concurrently"<<endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// function used to run one case of the stress test
+// the same batch is run on one thread and on numOfThreads threads, every run has to give the same result on both
+bool runCase(const string& name, int electorates, int days, uint64_t seed, int numOfThreads, bool generate, CampaignOrder order, int branchDay){
+
+    vector<BatchRunResult> results[2];
+    int threads[2] = {1, numOfThreads};
+
+    for(int x = 0; x < 2; x++){
+        BatchSimulator batch(electorates, days, stressRuns, threads[x], seed);
+        if(generate){
+            ScenarioSpec scenario;
+            scenario.parse(stressScenario, seed);
+            batch.setScenario(scenario);
+        }
+        batch.setCampaignOrder(order);
+        batch.setBranchDay(branchDay);
+        batch.setRecordRuns(true);
+        batch.runBatch();
+        results[x] = batch.getRunResults();
+    }
+
+    bool same = compareRuns(results[0], results[1]);
+    cout<<(same ? "ok   " : "FAIL ")<<name<<endl;
+    return same;
+}
+
+// Main function which runs every case of the stress test
+// returns 1 if any election gave a different result when run with other elections at the same time
+int main(int argle, char* argv[]){
+
+    uint64_t seed = 1;
+    int numOfThreads = max(8, (int)thread::hardware_concurrency());
+
+    if(argle % 2 == 0){
+        cerr<<"Please enter valid arguments:\n./<stress test exe> [--seed <seed>] [--threads <number of threads>]"<<endl;
+        return 1;
+    }
+
+    for(int x = 1; x < argle; x += 2){
+        string option = argv[x];
+        if(option == "--seed") seed = stoull(argv[x + 1]);
+        else if(option == "--threads") numOfThreads = stoi(argv[x + 1]);
+        else{
+            cerr<<"Unknown option "<<option<<endl;
+            return 1;
+        }
+    }
+
+    if(numOfThreads < 2){
+        cerr<<"Number of threads must be at least 2."<<endl;
+        return 1;
+    }
+
+    cout<<"# Election Simulator stress test, "<<stressRuns<<" elections on 1 and "<<numOfThreads<<" threads (seed "<<seed<<")"<<endl;
+
+    bool passed = true;
+    passed &= runCase("text files", 10, 30, seed, numOfThreads, false, CampaignOrder::DAY_MAJOR, -1);
+    passed &= runCase("text files/order=electorate", 10, 30, seed, numOfThreads, false, CampaignOrder::ELECTORATE_MAJOR, -1);
+    passed &= runCase("generated", 200, 30, seed, numOfThreads, true, CampaignOrder::DAY_MAJOR, -1);
+    passed &= runCase("generated/order=electorate", 200, 30, seed, numOfThreads, true, CampaignOrder::ELECTORATE_MAJOR, -1);
+    passed &= runCase("generated/branch-day=15", 200, 30, seed, numOfThreads, true, CampaignOrder::DAY_MAJOR, 15);
+
+    return passed ? 0 : 1;
+}